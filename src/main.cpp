@@ -2,31 +2,66 @@
 /// @copyright (c) 2025 Anstro Pleuton
 /// This project is released under the Public Domain or licensed under the terms of MIT license.
 
+#include <cstdio>
+#include <cstring>
+
 #include "raylib.h"
 #include "raymath.h"
 #include "rlms.hpp"
 #include "rlmsg.hpp"
+#include "rlmslog.hpp"
+#include "rlmssolve.hpp"
 
 using namespace rlms;
 using namespace rlmsg;
 
-/// Shrink a rectangle from all sides.
-Rectangle ShrinkRec(Rectangle rec, float shrink) {
-    return {rec.x + shrink, rec.y + shrink, rec.width - shrink * 2.0f, rec.height - shrink * 2.0f};
+/// Check if any input that may change the frame happened since the last poll.
+bool InputActivity() {
+    const Vector2 delta = GetMouseDelta();
+    if (delta.x != 0.0f || delta.y != 0.0f) return true;
+    if (GetMouseWheelMove() != 0.0f) return true;
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++) {
+        if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) return true;
+    }
+
+    return GetKeyPressed() != 0 || IsWindowResized();
+}
+
+/// Apply the click on the board, recording it if it is on a cell.
+void Click(minesweeper &ms, action_recorder &recorder, double gameTime, const action &a, change_set &changes) {
+    if (a.x >= 0 && a.x < ms.cfg.width && a.y >= 0 && a.y < ms.cfg.height) {
+        recorder.record((std::uint32_t)(gameTime * 1000.0), a);
+    }
+
+    if (a.type == action_type::primary) ms.primary_click(a.x, a.y, &changes);
+    else ms.secondary_click(a.x, a.y, &changes);
 }
 
-int main() {
+/// Record the end of the game. Cascades still in progress are finished first,
+/// as the replay completes them.
+void EndGame(minesweeper &ms, action_recorder &recorder) {
+    if (!recorder.is_open()) return;
+
+    while (ms.cascading()) ms.step_cascade(0, nullptr);
+    recorder.end_game(ms);
+}
+
+int main(int argc, char **argv) {
+    // The clicks of every game are appended to the action log given with
+    // --record, to replay them with rlms_replay
+    action_recorder recorder;
+    if (argc == 3 && std::strcmp(argv[1], "--record") == 0 && !recorder.open(argv[2])) {
+        std::fprintf(stderr, "Could not open %s\n", argv[2]);
+        return 1;
+    }
+
     SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_MSAA_4X_HINT);
     InitWindow(512, 512, "RLMS - raylib minesweeper");
     SetTargetFPS(60);
 
     LoadResources();
 
-    const float bevelThick     = 5.0f;
-    const float cellBevelThick = 2.0f;
-    const float panelHeight    = 63.0f - bevelThick;
-    const float statusHeight   = 63.0f - bevelThick;
-
     // This config is used to display config on screen and allow users to edit it.
     // The actual current board config is in ms.cfg.
     config cfg = {
@@ -37,15 +72,41 @@ int main() {
 
     minesweeper ms;
 
+    // Reveal cascades on large boards are spread over frames, advancing in
+    // steps until the frame's cascade time is used up
+    const double cascadeTime = 0.004;
+    ms.cascade_budget        = 1024;
+
+    // Generated boards are checked on all the cores
+    thread_pool  solverPool;
+    tiled_solver solver(solverPool);
+    ms.solver = &solver;
+
+    // Changes since the last frame, to update the board texture with
+    change_set   changes;
+    BoardTexture boardTexture;
+
     float time = 0.0f;
     ms.cfg     = cfg;
     ms.cfg.randomize_seed();
     ms.reset();
+    recorder.begin_game(ms.cfg);
+    double gameStart = GetTime();
 
-    while (!WindowShouldClose()) {
-        BeginDrawing();
+    // Idle mode: the frame is redrawn only on input, resize, theme toggle or
+    // timer tick. While a button is held or a cascade is in progress, the
+    // frame is redrawn continuously.
+    double lastTime     = GetTime();
+    bool   eventWaiting = false;
+    bool   redraw       = true;
+    int    shownTimer   = 0;
 
-        if (IsKeyPressed(KEY_SPACE)) isDarkTheme = !isDarkTheme;
+    while (!WindowShouldClose()) {
+        // Accumulate the timer from the wall clock, as the frames may be far
+        // apart in idle mode
+        const double now = GetTime();
+        if (ms.state == game_state::playing) time += now - lastTime;
+        lastTime = now;
 
         // Shorthands
         const Rectangle screen    = {0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight()};
@@ -56,145 +117,86 @@ int main() {
         const bool      leftRel   = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
         const bool      rightRel  = IsMouseButtonReleased(MOUSE_BUTTON_RIGHT);
 
-        // Main box
-        const Rectangle screenBox  = screen;
-        const Rectangle screenArea = ShrinkRec(screenBox, bevelThick);
-        DrawBeveledRectangle(screenBox, bevelThick);
-
-        // Top panel
-        const Rectangle panelBox  = {bevelThick, bevelThick, screenBox.width - bevelThick * 2.0f, panelHeight};
-        const Rectangle panelArea = ShrinkRec(panelBox, bevelThick);
-        DrawBeveledRectangleInv(panelBox, bevelThick);
-
-        // Score display
-        const int     score         = ms.cells_flagged();
-        const char   *scoreText     = TextFormat("%03d", score);
-        const Vector2 scorePosition = {panelArea.x, panelArea.y};
-        DrawLEDText(scoreText, scorePosition, 48.0f);
-
-        // Time display
-        if (ms.state == game_state::playing) time += GetFrameTime();
-        const int     timer         = time;
-        const char   *timerText     = TextFormat("%03d", timer);
-        const Vector2 timerPosition = {panelArea.x + panelArea.width - MeasureLEDText(timerText, 48.0f).x, panelArea.y};
-        DrawLEDText(timerText, timerPosition, 48.0f);
-
-        // Smiley - The personal judger
-        const Rectangle smileyBox  = {(GetScreenWidth() - 48.0f) / 2.0f, panelArea.y, 48.0f, 48.0f};
-        const Rectangle smileyArea = ShrinkRec(smileyBox, bevelThick);
-
-        const Texture texture =
-            ms.state == game_state::lost
-                ? faceLost
-            : ms.state == game_state::won
-                ? faceWon
-            : held
-                ? faceClicking
-                : face;
-
-        if (CheckCollisionPointRec(mouse, smileyBox) && leftRel) {
+        if (!redraw && !held && !ms.cascading() && !InputActivity() && (int)time == shownTimer) {
+            // Nothing changed, keep the last frame. This blocks until the next
+            // event in event waiting mode, otherwise it polls for the timer.
+            if (!eventWaiting) WaitTime(1.0 / 60.0);
+            PollInputEvents();
+            continue;
+        }
+
+        redraw = false;
+
+        if (IsKeyPressed(KEY_SPACE)) isDarkTheme = !isDarkTheme;
+
+        // Handle the input before drawing, so the frame shows its effects
+        Layout layout = ComputeLayout(screen, ms.cfg.width, ms.cfg.height);
+        int    mCellX = 0;
+        int    mCellY = 0;
+        GetCellAt(layout, mouse, mCellX, mCellY);
+
+        const bool onSmiley = CheckCollisionPointRec(mouse, layout.smileyBox);
+        if (onSmiley && leftRel) {
+            EndGame(ms, recorder);
             time   = 0.0f;
             ms.cfg = cfg;
             ms.cfg.randomize_seed();
             ms.reset();
+            recorder.begin_game(ms.cfg);
+            gameStart = now;
+        } else {
+            if (leftRel) Click(ms, recorder, now - gameStart, {action_type::primary, mCellX, mCellY}, changes);
+            if (rightRel) Click(ms, recorder, now - gameStart, {action_type::secondary, mCellX, mCellY}, changes);
+        }
+
+        if (CheckCollisionPointRec(mouse, layout.widthBox)) cfg.width += GetMouseWheelMove();
+        if (CheckCollisionPointRec(mouse, layout.heightBox)) cfg.height += GetMouseWheelMove();
+        if (CheckCollisionPointRec(mouse, layout.minesBox)) cfg.mines += GetMouseWheelMove();
+
+        // Advance the cascade, the clicks made meanwhile are applied once it ends
+        const double cascadeStart = GetTime();
+        while (ms.cascading() && GetTime() - cascadeStart < cascadeTime) {
+            ms.step_cascade(ms.cascade_budget, &changes);
         }
 
-        const bool gameOver = ms.state == game_state::won || ms.state == game_state::lost;
-
-        if (CheckCollisionPointRec(mouse, smileyBox) && leftHeld)
-            DrawBeveledRectangleInv(smileyBox, bevelThick);
-        else
-            DrawBeveledRectangle(smileyBox, bevelThick);
-        DrawTextureDest(texture, smileyArea);
-
-        // Bottom panel
-        const Rectangle statusBox  = {bevelThick, screenBox.height - statusHeight - bevelThick, screenBox.width - bevelThick * 2.0f, statusHeight};
-        const Rectangle statusArea = ShrinkRec(statusBox, bevelThick);
-        DrawBeveledRectangleInv(statusBox, bevelThick);
-
-        // Show editable config
-        const Rectangle widthBox = {statusArea.x + 0.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
-        if (CheckCollisionPointRec(mouse, widthBox)) cfg.width += GetMouseWheelMove();
-        DrawTextCentered(font24, TextFormat("Width: %d", cfg.width), widthBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
-        const Rectangle heightBox = {statusArea.x + 1.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
-        if (CheckCollisionPointRec(mouse, heightBox)) cfg.height += GetMouseWheelMove();
-        DrawTextCentered(font24, TextFormat("Height: %d", cfg.height), heightBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
-        const Rectangle minesBox = {statusArea.x + 2.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
-        if (CheckCollisionPointRec(mouse, minesBox)) cfg.mines += GetMouseWheelMove();
-        DrawTextCentered(font24, TextFormat("Mines: %d", cfg.mines), minesBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
-
-        // Board box
-        const Rectangle boardBox  = {screenArea.x, screenArea.y + panelBox.height, screenArea.width, screenArea.height - panelBox.height - statusBox.height};
-        const Rectangle boardArea = ShrinkRec(boardBox, bevelThick);
-        DrawBeveledRectangleInv(boardBox, bevelThick);
-
-        // Render grid
-        const Vector2 cellSizeV = {boardArea.width / ms.cfg.width, boardArea.height / ms.cfg.height};
-        const float   cellSize  = std::min(cellSizeV.x, cellSizeV.y);
-        const Vector2 padding   = cellSizeV.x > cellSizeV.y ? Vector2{(cellSizeV.x - cellSizeV.y) * ms.cfg.width / 2.0f, 0.0f} : Vector2{0.0f, (cellSizeV.y - cellSizeV.x) * ms.cfg.height / 2.0f};
-        const int     mCellX    = std::floor((mouse.x - boardArea.x - padding.x) / cellSize);
-        const int     mCellY    = std::floor((mouse.y - boardArea.y - padding.y) / cellSize);
-
-        for (int x = 0; x < ms.cfg.width; x++) {
-            for (int y = 0; y < ms.cfg.height; y++) {
-                const Rectangle cellBox    = {boardArea.x + padding.x + cellSize * x, boardArea.y + padding.y + cellSize * y, cellSize, cellSize};
-                const Rectangle cellArea   = ShrinkRec(cellBox, cellBevelThick);
-                const Rectangle cellArea24 = {cellArea.x + (cellArea.width - 32.0f) / 2.0f, cellArea.y + (cellArea.height - 32.0f) / 2.0f, 32.0f, 32.0f};
-                const cell      cell       = ms.at(x, y);
-                const bool      colliding  = mCellX == x && mCellY == y;
-
-                // Click actions
-                if (colliding && leftRel) {
-                    ms.primary_click(x, y);
-                }
-
-                if (colliding && rightRel) {
-                    ms.secondary_click(x, y);
-                }
-
-                bool collidingNeighbors = false;
-                for (auto [nx, ny] : ms.neighbors(x, y)) {
-                    if (mCellX == nx && mCellY == ny && ms.at(nx, ny).state == cell_state::revealed) {
-                        collidingNeighbors = true;
-                        break;
-                    }
-                }
-
-                // Render cell
-                if (cell.state != cell_state::revealed) {
-                    if (!gameOver && held && cell.state == cell_state::hidden && (collidingNeighbors || colliding))
-                        DrawBeveledRectangleInv(cellBox, cellBevelThick);
-                    else
-                        DrawBeveledRectangle(cellBox, cellBevelThick);
-
-                    if (cell.state == cell_state::flagged) {
-                        DrawTextureDest(flag, cellArea24);
-                        if (gameOver && !cell.is_mine) {
-                            DrawTextureDest(crossMark, cellArea24);
-                        }
-                    }
-                    if (cell.state == cell_state::qmarked) {
-                        DrawTextCentered(font32, "?", cellArea, 32.0f, 0.0f, isDarkTheme ? textDark : textLight);
-                    }
-
-                    if (gameOver && cell.state == cell_state::hidden && cell.is_mine) {
-                        DrawTextureDest(bomb, cellArea24);
-                    }
-                } else {
-                    if (cell.n_mines != 0) {
-                        DrawTextCentered(font32, TextFormat("%d", cell.n_mines), cellArea, 32.0f, 0.0f, GetMineNumberColor(cell.n_mines));
-                    }
-                    if (cell.is_mine) {
-                        DrawRectangleRec(cellArea, incorrect);
-                        DrawTextureDest(bomb, cellArea24);
-                    }
-                }
-            }
+        // The board may have been resized by a reset
+        layout = ComputeLayout(screen, ms.cfg.width, ms.cfg.height);
+
+        // Keep the board texture up to date only while it is used
+        if (UseBoardTexture(layout)) UpdateBoardTexture(boardTexture, ms, changes);
+        else boardTexture.valid = false;
+        changes.clear();
+
+        const GameView view = {
+            .ms            = &ms,
+            .cfg           = &cfg,
+            .timer         = (int)time,
+            .mouseCellX    = mCellX,
+            .mouseCellY    = mCellY,
+            .held          = held,
+            .smileyPressed = onSmiley && leftHeld,
+            .boardTexture  = &boardTexture,
+        };
+
+        // Block on events only when the timer does not need to tick, decided
+        // after the input so a click that starts the game or a cascade keeps
+        // the frames coming
+        const bool wantEventWaiting = !held && ms.state != game_state::playing && !ms.cascading();
+        if (wantEventWaiting != eventWaiting) {
+            if (wantEventWaiting) EnableEventWaiting();
+            else DisableEventWaiting();
+            eventWaiting = wantEventWaiting;
         }
 
+        BeginDrawing();
+        DrawGame(layout, view);
+        shownTimer = view.timer;
         EndDrawing();
     }
 
+    EndGame(ms, recorder);
+
+    UnloadBoardTexture(boardTexture);
     UnloadResources();
 
     CloseWindow();
@@ -0,0 +1,162 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "rlmsg.hpp"
+#include "rlmssim.hpp"
+
+using namespace rlms;
+using namespace rlmsg;
+
+/// Print the usage of the headless render benchmark.
+void PrintUsage(const char *program) {
+    std::printf("Usage: %s [options]\n", program);
+    std::printf("  --width N      Board width (default 30).\n");
+    std::printf("  --height N     Board height (default 16).\n");
+    std::printf("  --mines N      Number of mines (default 99).\n");
+    std::printf("  --seed N       Board seed (default 0).\n");
+    std::printf("  --screen WxH   Screen size (default 1024x640).\n");
+    std::printf("  --frames N     Number of frames to build (default 1000).\n");
+    std::printf("  --dump FILE    Write the draw commands of one frame to the file.\n");
+}
+
+int main(int argc, char **argv) {
+    config cfg = {
+        .width  = 30,
+        .height = 16,
+        .mines  = 99,
+    };
+
+    float       screenWidth  = 1024.0f;
+    float       screenHeight = 640.0f;
+    int         frames       = 1000;
+    std::string dumpPath;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 1;
+        }
+
+        const char *value = argv[++i];
+
+        if (arg == "--width") cfg.width = std::atoi(value);
+        else if (arg == "--height") cfg.height = std::atoi(value);
+        else if (arg == "--mines") cfg.mines = std::atoi(value);
+        else if (arg == "--seed") cfg.seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--frames") frames = std::atoi(value);
+        else if (arg == "--dump") dumpPath = value;
+        else if (arg == "--screen") {
+            if (std::sscanf(value, "%fx%f", &screenWidth, &screenHeight) != 2) {
+                std::fprintf(stderr, "Invalid screen size: %s\n", value);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!cfg.validate() || frames <= 0) {
+        std::fprintf(stderr, "Invalid configuration\n");
+        return 1;
+    }
+
+    // Play the bot until about half the safe cells are revealed, for a
+    // typical mid-game mix of hidden, flagged and revealed cells. Solvability
+    // does not matter here, a single generation attempt will do.
+    minesweeper ms;
+    ms.cfg          = cfg;
+    ms.cfg.attempts = 1;
+    ms.reset();
+
+    deduction_player bot;
+    bot.begin(ms);
+
+    const int  safeCells = cfg.width * cfg.height - cfg.mines;
+    int        revealed  = 0;
+    change_set changes;
+    while (ms.state == game_state::first_click || (ms.state == game_state::playing && revealed < safeCells / 2)) {
+        const action a = bot.next(ms);
+        if (a.type == action_type::primary) ms.primary_click(a.x, a.y, &changes);
+        else ms.secondary_click(a.x, a.y, &changes);
+
+        for (const auto &change : changes.cells) {
+            if (change.state == cell_state::revealed) revealed++;
+        }
+        changes.clear();
+    }
+
+    RecordingRenderer recorder;
+    SetRenderer(recorder);
+
+    // Boards too large for tiles are drawn from the board texture
+    const Layout layout = ComputeLayout({0.0f, 0.0f, screenWidth, screenHeight}, cfg.width, cfg.height);
+    BoardTexture boardTexture;
+    if (UseBoardTexture(layout)) {
+        UpdateBoardTexture(boardTexture, ms, change_set());
+    }
+
+    const GameView view = {
+        .ms            = &ms,
+        .cfg           = &cfg,
+        .timer         = 123,
+        .mouseCellX    = cfg.width / 2,
+        .mouseCellY    = cfg.height / 2,
+        .held          = true,
+        .smileyPressed = false,
+        .boardTexture  = &boardTexture,
+    };
+
+    latency_histogram frameLatency;
+    const auto        start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; frame++) {
+        const auto frameStart = std::chrono::steady_clock::now();
+        recorder.Clear();
+        DrawGame(layout, view);
+        frameLatency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameStart).count());
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("Board %dx%d, %d mines, %d of %d safe cells revealed, screen %.0fx%.0f, %s\n",
+                cfg.width, cfg.height, cfg.mines, revealed, safeCells, screenWidth, screenHeight,
+                UseBoardTexture(layout) ? "board texture" : "tiles");
+    std::printf("Commands/frame %zu (rect %zu, tri %zu, text %zu, tex %zu), text bytes %zu\n",
+                recorder.commands.size(),
+                recorder.Count(DrawCommandType::Rectangle),
+                recorder.Count(DrawCommandType::Triangle),
+                recorder.Count(DrawCommandType::Text),
+                recorder.Count(DrawCommandType::Texture),
+                recorder.textBuffer.size());
+    std::printf("Frame build   p50 %10.1f us  p99 %10.1f us  max %10.1f us  (%.0f frames/s)\n",
+                frameLatency.percentile(0.50) / 1e3,
+                frameLatency.percentile(0.99) / 1e3,
+                frameLatency.max / 1e3,
+                frames / seconds);
+
+    if (!dumpPath.empty()) {
+        std::FILE *file = std::fopen(dumpPath.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "Could not open %s\n", dumpPath.c_str());
+            return 1;
+        }
+        const std::string text = recorder.Serialize();
+        std::fwrite(text.data(), 1, text.size(), file);
+        std::fclose(file);
+    }
+}
@@ -0,0 +1,150 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "rlmslog.hpp"
+
+using namespace rlms;
+
+/// Print the usage of the headless replayer.
+void PrintUsage(const char *program) {
+    std::printf("Usage: %s [options] LOG...\n", program);
+    std::printf("  --repeat N     Replay every game N times (default 1).\n");
+    std::printf("  --threads N    Number of worker threads (default all cores).\n");
+}
+
+/// Print the histogram percentiles, in microseconds.
+void PrintLatency(const char *name, const latency_histogram &histogram) {
+    std::printf("%-14s p50 %10.1f us  p90 %10.1f us  p99 %10.1f us  max %10.1f us\n",
+                name,
+                histogram.percentile(0.50) / 1e3,
+                histogram.percentile(0.90) / 1e3,
+                histogram.percentile(0.99) / 1e3,
+                histogram.max / 1e3);
+}
+
+/// Per-worker replay state.
+struct WorkerContext {
+    minesweeper       ms;
+    latency_histogram gameLatency;
+    latency_histogram clickLatency;
+    std::vector<int>  mismatches; ///< Indices of the games whose final state differs.
+};
+
+int main(int argc, char **argv) {
+    std::vector<std::string> paths;
+    int                      repeat  = 1;
+    int                      threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+
+        if (arg.starts_with("--")) {
+            if (i + 1 >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                return 1;
+            }
+
+            const char *value = argv[++i];
+
+            if (arg == "--repeat") repeat = std::atoi(value);
+            else if (arg == "--threads") threads = std::atoi(value);
+            else {
+                std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty() || repeat <= 0) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    // The games of all the logs, and where they came from
+    std::vector<game_log>    games;
+    std::vector<std::string> sources;
+    for (const auto &path : paths) {
+        const std::size_t first = games.size();
+        if (!read_action_log(path, games)) {
+            std::fprintf(stderr, "Could not read %s%s\n", path.c_str(), games.size() > first ? " entirely" : "");
+            return 1;
+        }
+        for (std::size_t i = first; i < games.size(); i++) {
+            sources.push_back(path + " game " + std::to_string(i - first + 1));
+        }
+    }
+
+    if (games.empty()) {
+        std::fprintf(stderr, "No games recorded\n");
+        return 1;
+    }
+
+    std::uint64_t actions   = 0;
+    std::uint64_t unchecked = 0;
+    for (const auto &game : games) {
+        actions += game.actions.size();
+        unchecked += !game.ended;
+    }
+
+    thread_pool                pool(threads);
+    std::vector<WorkerContext> contexts(pool.size());
+
+    const int  n_games = games.size();
+    const auto start   = std::chrono::steady_clock::now();
+
+    pool.run(n_games * repeat, [&](int task, int worker) {
+        WorkerContext &ctx  = contexts[worker];
+        const int      game = task % n_games;
+
+        const auto gameStart = std::chrono::steady_clock::now();
+        if (!replay(ctx.ms, games[game], &ctx.clickLatency)) {
+            ctx.mismatches.push_back(game);
+        }
+        ctx.gameLatency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gameStart).count());
+    });
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    latency_histogram gameLatency;
+    latency_histogram clickLatency;
+    std::vector<int>  mismatches;
+    for (const auto &ctx : contexts) {
+        gameLatency.merge(ctx.gameLatency);
+        clickLatency.merge(ctx.clickLatency);
+        mismatches.insert(mismatches.end(), ctx.mismatches.begin(), ctx.mismatches.end());
+    }
+    std::sort(mismatches.begin(), mismatches.end());
+    mismatches.erase(std::unique(mismatches.begin(), mismatches.end()), mismatches.end());
+
+    std::printf("games          %d (%llu without recorded end)\n", n_games, (unsigned long long)unchecked);
+    std::printf("actions        %llu\n", (unsigned long long)actions);
+    std::printf("threads        %d\n", pool.size());
+    std::printf("replays        %llu\n", (unsigned long long)n_games * repeat);
+    std::printf("games/sec      %.1f\n", n_games * repeat / seconds);
+    std::printf("actions/sec    %.1f\n", actions * repeat / seconds);
+    std::printf("mismatches     %zu\n", mismatches.size());
+    PrintLatency("game latency", gameLatency);
+    PrintLatency("click latency", clickLatency);
+
+    for (int game : mismatches) {
+        std::printf("final state differs: %s\n", sources[game].c_str());
+    }
+
+    return mismatches.empty() ? 0 : 1;
+}
@@ -3,10 +3,427 @@
 /// This project is released under the Public Domain or licensed under the terms of MIT license.
 
 #include <algorithm>
-#include <queue>
+#include <cstdlib>
+#include <deque>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
 
 #include "rlms.hpp"
+#include "rlmssolve.hpp"
+
+namespace {
+
+/// Cell decision of the constructive generator.
+enum class decision : std::uint8_t {
+    undecided,
+    pending,  ///< Safe, not revealed yet.
+    revealed, ///< Safe and revealed, all of its neighbors are decided.
+    anchor,   ///< Revealed, and has decided some of its neighbors.
+    mine
+};
+
+/// Max cells to explore when looking for a walled off pocket of cells.
+constexpr int max_pocket = 64;
+
+/// Place the mines by growing the deduced region from the first click.
+///
+/// The safe cells are revealed in order, and the undecided neighbors of each
+/// revealed cell are decided all mines or all safe. Once the other neighbors
+/// of the cell are resolved, its number then forces them all to be flagged or
+/// revealed, so every decided cell is eventually deduced by the solver.
+/// Undecided cells that get walled off by mines can never be reached, so they
+/// are made mines right away, if there are enough mines left for them. When
+/// too many mines are left for the cells left, an earlier safe group that
+/// has not decided anything yet is turned into mines.
+///
+/// @return True if the board is logically solvable by construction. False if
+///         the mine count forced a step that breaks it, in which case the
+///         mines are still placed but the board has to be checked.
+template <typename Engine>
+bool construct_mines(rlms::minesweeper &ms, int x, int y, Engine &gen) {
+    const int width  = ms.cfg.width;
+    const int height = ms.cfg.height;
+
+    std::pmr::memory_resource *scratch = &ms.scratch;
+
+    std::pmr::vector<decision> decided(width * height, decision::undecided, scratch);
+    const auto                 index = [&](int x, int y) { return x * height + y; };
+
+    int  mines     = ms.cfg.mines;   // Mines left to place
+    int  undecided = width * height; // Cells left to decide
+    bool forced    = true;
+
+    // Decided safe cells, in the order they get revealed
+    std::pmr::deque<std::pair<int, int>> pending(scratch);
+
+    // The first click and its neighbors are safe
+    decided[index(x, y)] = decision::pending;
+    undecided--;
+    pending.emplace_back(x, y);
+    for (auto [nx, ny] : ms.neighbors(x, y)) {
+        decided[index(nx, ny)] = decision::pending;
+        undecided--;
+        pending.emplace_back(nx, ny);
+    }
+
+    // Check if the undecided cell is walled off from all pending cells, and
+    // append its walled off region to the pocket (marked as mines). Gives up
+    // with false once the region grows past the limit.
+    const auto walled = [&](int ux, int uy, std::pmr::vector<std::pair<int, int>> &pocket, std::size_t limit) {
+        const std::size_t begin = pocket.size();
+
+        decided[index(ux, uy)] = decision::mine;
+        pocket.emplace_back(ux, uy);
+
+        // Breadth first, the pending cells are usually close
+        bool reachable = false;
+        for (std::size_t j = begin; j < pocket.size() && !reachable; j++) {
+            auto [cx, cy] = pocket[j];
+
+            for (auto [nx, ny] : ms.neighbors(cx, cy)) {
+                if (decided[index(nx, ny)] == decision::pending) {
+                    reachable = true;
+                    break;
+                }
+
+                if (decided[index(nx, ny)] == decision::undecided) {
+                    decided[index(nx, ny)] = decision::mine;
+                    pocket.emplace_back(nx, ny);
+                }
+            }
+
+            reachable = reachable || pocket.size() > limit;
+        }
+
+        if (reachable) {
+            for (std::size_t j = begin; j < pocket.size(); j++) {
+                decided[index(pocket[j].first, pocket[j].second)] = decision::undecided;
+            }
+
+            const bool too_large = pocket.size() > limit;
+            pocket.resize(begin);
+            return !too_large;
+        }
+
+        return true;
+    };
+
+    // Cells of the groups decided safe so far, and where each group begins
+    std::pmr::vector<std::pair<int, int>> safe_cells(scratch);
+    std::pmr::vector<std::size_t>         safe_groups(scratch);
+
+    rlms::neighbor_list        group;
+    std::pmr::vector<decision> flipped(scratch);
+
+    // Turn a safe group into mines, to take at least need mines off the
+    // count. This keeps the step of its revealed cell forced, as long as none
+    // of the group's cells decided other cells, and it does not wall off
+    // undecided cells.
+    const auto flip_safe_group = [&](int need, int mines) {
+        const std::size_t n_groups = safe_groups.size();
+        for (std::size_t g = n_groups; g > 0; g--) {
+            const std::size_t begin = safe_groups[g - 1];
+            const std::size_t end   = g < n_groups ? safe_groups[g] : safe_cells.size();
+            const int         size  = end - begin;
+
+            if (size < need || size > mines) {
+                continue;
+            }
+
+            bool ok = true;
+            for (std::size_t j = begin; j < end && ok; j++) {
+                const decision d = decided[index(safe_cells[j].first, safe_cells[j].second)];
+                ok               = d == decision::pending || d == decision::revealed;
+            }
+
+            if (!ok) {
+                continue;
+            }
+
+            flipped.clear();
+            for (std::size_t j = begin; j < end; j++) {
+                flipped.push_back(decided[index(safe_cells[j].first, safe_cells[j].second)]);
+                decided[index(safe_cells[j].first, safe_cells[j].second)] = decision::mine;
+            }
+
+            // Every undecided neighbor must still have a pending neighbor
+            for (std::size_t j = begin; j < end && ok; j++) {
+                for (auto [nx, ny] : ms.neighbors(safe_cells[j].first, safe_cells[j].second)) {
+                    if (decided[index(nx, ny)] != decision::undecided ||
+                        std::find(group.begin(), group.end(), std::make_pair(nx, ny)) != group.end()) {
+                        continue;
+                    }
+
+                    bool reachable = false;
+                    for (auto [vx, vy] : ms.neighbors(nx, ny)) {
+                        reachable = reachable ||
+                                    decided[index(vx, vy)] == decision::pending ||
+                                    std::find(group.begin(), group.end(), std::make_pair(vx, vy)) != group.end();
+                    }
+                    ok = ok && reachable;
+                }
+            }
+
+            if (ok) {
+                return size;
+            }
+
+            for (std::size_t j = begin; j < end; j++) {
+                decided[index(safe_cells[j].first, safe_cells[j].second)] = flipped[j - begin];
+            }
+        }
+
+        return 0;
+    };
+
+    std::pmr::vector<std::pair<int, int>> pocket(scratch);
+    while (!pending.empty()) {
+        auto [sx, sy] = pending.front();
+        pending.pop_front();
+
+        // Turned into a mine
+        if (decided[index(sx, sy)] != decision::pending) {
+            continue;
+        }
+
+        decided[index(sx, sy)] = decision::revealed;
+
+        // The number of the revealed cell depends on all of its neighbors
+        group.clear();
+        for (auto [nx, ny] : ms.neighbors(sx, sy)) {
+            if (decided[index(nx, ny)] == decision::undecided) {
+                group.emplace_back(nx, ny);
+            }
+        }
+
+        if (group.empty()) {
+            continue;
+        }
+
+        decided[index(sx, sy)] = decision::anchor;
+
+        const int k = group.size();
+
+        // Try making the group mines, along with the pockets it walls off
+        bool can_mine = k <= mines;
+        pocket.clear();
+        if (can_mine) {
+            for (auto [gx, gy] : group) {
+                decided[index(gx, gy)] = decision::mine;
+            }
+
+            for (auto [gx, gy] : group) {
+                for (auto [nx, ny] : ms.neighbors(gx, gy)) {
+                    if (can_mine && decided[index(nx, ny)] == decision::undecided) {
+                        can_mine = walled(nx, ny, pocket, std::min(mines - k, max_pocket));
+                    }
+                }
+            }
+
+            can_mine = can_mine && k + (int)pocket.size() <= mines;
+
+            // The pockets may be too large to notice, never wall off the rest
+            // of the board unless it can be filled with mines
+            const int rest = undecided - k - pocket.size();
+            if (can_mine && mines - k - (int)pocket.size() != rest) {
+                can_mine = false;
+                for (auto it = pending.rbegin(); it != pending.rend() && !can_mine; ++it) {
+                    for (auto [nx, ny] : ms.neighbors(it->first, it->second)) {
+                        can_mine = can_mine || decided[index(nx, ny)] == decision::undecided;
+                    }
+                }
+            }
+        }
+
+        const bool can_safe = mines <= undecided - k;
+
+        bool mine = can_mine;
+        if (can_mine && can_safe) {
+            // Pick mines with the probability that keeps the expected density
+            // of the decided cells at the density of the undecided cells
+            const double d = (double)mines / undecided;
+            const double q = d * k / ((k + pocket.size()) * (1.0 - d) + d * k);
+            mine           = std::bernoulli_distribution(q)(gen);
+        }
+
+        if (mine) {
+            mines     -= k + pocket.size();
+            undecided -= k + pocket.size();
+            continue;
+        }
+
+        // Roll back the mines
+        for (auto [px, py] : pocket) {
+            decided[index(px, py)] = decision::undecided;
+        }
+
+        // Too many mines left to make the group safe. Take them off an
+        // earlier safe group, or if there is none, place the fewest mines
+        // that fit, which may not keep the step forced.
+        int m = 0;
+        if (!can_safe) {
+            const int need = mines - (undecided - k);
+            if (const int flipped = flip_safe_group(need, mines)) {
+                mines -= flipped;
+            } else {
+                forced = false;
+                m      = std::min(k, need);
+                for (int j = 0; j < m; j++) {
+                    std::uniform_int_distribution<int> dist(j, k - 1);
+                    std::swap(group[j], group[dist(gen)]);
+                }
+            }
+        }
+
+        if (m == 0) {
+            safe_groups.push_back(safe_cells.size());
+        }
+
+        for (int j = 0; j < k; j++) {
+            auto [gx, gy] = group[j];
+            if (j < m) {
+                decided[index(gx, gy)] = decision::mine;
+            } else {
+                decided[index(gx, gy)] = decision::pending;
+                pending.emplace_back(gx, gy);
+
+                if (m == 0) {
+                    safe_cells.emplace_back(gx, gy);
+                }
+            }
+        }
+
+        mines     -= m;
+        undecided -= k;
+    }
+
+    // The cells left are walled off by mines, they can only be mines
+    std::pmr::vector<std::pair<int, int>> left(scratch);
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            if (decided[index(x, y)] == decision::undecided) {
+                left.emplace_back(x, y);
+            }
+        }
+    }
+
+    if (mines != undecided) {
+        forced = false;
+        std::shuffle(left.begin(), left.end(), gen);
+    }
+
+    for (int j = 0; j < mines && j < (int)left.size(); j++) {
+        auto [lx, ly]          = left[j];
+        decided[index(lx, ly)] = decision::mine;
+    }
+
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            ms.at(x, y).is_mine = decided[index(x, y)] == decision::mine;
+        }
+    }
+
+    return forced;
+}
+
+/// Whether the cell has a revealed neighbor, from its neighbor state counters.
+bool has_revealed_neighbor(const rlms::minesweeper &ms, int x, int y) {
+    const int columns = std::min(x + 1, ms.cfg.width - 1) - std::max(x - 1, 0) + 1;
+    const int rows    = std::min(y + 1, ms.cfg.height - 1) - std::max(y - 1, 0) + 1;
+    const auto &c     = ms.board[x][y];
+    return columns * rows - 1 > c.n_hidden + c.n_marked;
+}
+
+/// Unite the frontier cell with the frontier cells sharing a revealed
+/// neighbor. All the frontier neighbors of a revealed cell are already in one
+/// component, so uniting with one of them is enough.
+void join_frontier(rlms::minesweeper &ms, int x, int y) {
+    const int index = x * ms.cfg.height + y;
+
+    for (auto [rx, ry] : ms.neighbors(x, y)) {
+        if (ms.board[rx][ry].state != rlms::cell_state::revealed) {
+            continue;
+        }
+
+        for (auto [nx, ny] : ms.neighbors(rx, ry)) {
+            const int neighbor = nx * ms.cfg.height + ny;
+            if (neighbor != index && ms.frontier.contains(neighbor)) {
+                ms.frontier.unite(index, neighbor);
+                break;
+            }
+        }
+    }
+}
+
+/// Update the frontier after the cell's state changed from the old state.
+void update_frontier(rlms::minesweeper &ms, int x, int y, rlms::cell_state old_state) {
+    using rlms::cell_state;
+
+    const cell_state new_state = ms.board[x][y].state;
+    const int        index     = x * ms.cfg.height + y;
+
+    // The cell itself
+    if (new_state == cell_state::hidden && has_revealed_neighbor(ms, x, y)) {
+        if (!ms.frontier.contains(index)) {
+            ms.frontier.insert(index);
+            if (!ms.frontier.components_stale()) {
+                join_frontier(ms, x, y);
+            }
+        }
+    } else {
+        ms.frontier.erase(index);
+    }
+
+    // The hidden neighbors gained or lost a revealed neighbor. The hidden
+    // neighbors of a revealed 0 mines cell are left out, as the cascade
+    // reveals them right after.
+    const rlms::cell &c        = ms.board[x][y];
+    const bool        cascades = new_state == cell_state::revealed && c.n_mines == 0 && !c.is_mine;
+    if (!cascades && (old_state == cell_state::revealed) != (new_state == cell_state::revealed)) {
+        int first = -1; // First frontier neighbor, the others join its component
+
+        for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, ms.cfg.width - 1); nx++) {
+            for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, ms.cfg.height - 1); ny++) {
+                if (ms.board[nx][ny].state != cell_state::hidden) {
+                    continue;
+                }
+
+                const int neighbor = nx * ms.cfg.height + ny;
+                if (new_state != cell_state::revealed) {
+                    if (!has_revealed_neighbor(ms, nx, ny)) {
+                        ms.frontier.erase(neighbor);
+                    }
+                    continue;
+                }
+
+                // A hidden cell not yet on the frontier has no other revealed
+                // neighbor to join. Stale components are united again when
+                // queried, there is no point uniting them until then.
+                ms.frontier.insert(neighbor);
+                if (first < 0) {
+                    first = neighbor;
+                } else if (!ms.frontier.components_stale()) {
+                    ms.frontier.unite(first, neighbor);
+                }
+            }
+        }
+    }
+}
+
+/// Queue the cell for the reveal cascade, unless it already is.
+void push_wavefront(rlms::minesweeper &ms, int x, int y) {
+    rlms::cell &c = ms.at(x, y);
+    if (!c.in_wavefront) {
+        c.in_wavefront = true;
+        ms.wavefront.emplace_back(x, y);
+    }
+}
+
+} // namespace
+
+rlms::minesweeper::minesweeper(std::pmr::memory_resource *upstream)
+    : scratch(upstream) {}
 
 rlms::cell &rlms::minesweeper::at(int x, int y) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
@@ -36,20 +453,73 @@ void rlms::minesweeper::ensure_size() {
 
 void rlms::minesweeper::initialize_board() {
     state = game_state::first_click;
+
+    // Unqueue the cells of a cascade in progress, before the board resizes
+    for (auto [x, y] : wavefront) {
+        if (x < (int)board.size() && y < (int)board[x].size()) {
+            board[x][y].in_wavefront = false;
+        }
+    }
+    wavefront.clear();
+    pending_clicks.clear();
     ensure_size();
 }
 
 void rlms::minesweeper::reset() {
-    board = {};
+    // Reuse the existing board storage instead of reallocating it
+    ensure_size();
+    for (auto &linear : board) {
+        std::fill(linear.begin(), linear.end(), cell());
+    }
+
+    reset_states();
     initialize_board();
 }
 
-std::vector<std::pair<int, int>> rlms::minesweeper::neighbors(int x, int y) const {
+void rlms::minesweeper::reset_states() {
+    flags = 0;
+    frontier.resize(cfg.width * cfg.height);
+
+    for (int x = 0; x < cfg.width; x++) {
+        // Number of columns in the neighborhood, including the cell's own
+        const int columns = std::min(x + 1, cfg.width - 1) - std::max(x - 1, 0) + 1;
+
+        for (int y = 0; y < cfg.height; y++) {
+            const int rows = std::min(y + 1, cfg.height - 1) - std::max(y - 1, 0) + 1;
+
+            cell &c     = board[x][y];
+            c.state     = cell_state::hidden;
+            c.n_hidden  = columns * rows - 1;
+            c.n_flagged = 0;
+            c.n_marked  = 0;
+        }
+    }
+}
+
+int rlms::minesweeper::frontier_component(int x, int y) {
+    if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
+        return -1;
+    }
+
+    // Erasing may have split components, which union-find can not follow,
+    // unite the frontier cells again
+    if (frontier.components_stale()) {
+        frontier.reset_components();
+        for (int cell : frontier) {
+            join_frontier(*this, cell / cfg.height, cell % cfg.height);
+        }
+    }
+
+    const int index = x * cfg.height + y;
+    return frontier.contains(index) ? frontier.find(index) : -1;
+}
+
+rlms::neighbor_list rlms::minesweeper::neighbors(int x, int y) const {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return {};
     }
 
-    std::vector<std::pair<int, int>> neighbors;
+    neighbor_list neighbors;
 
     for (int dx = -1; dx <= 1; dx++) {
         for (int dy = -1; dy <= 1; dy++) {
@@ -72,6 +542,15 @@ std::vector<std::pair<int, int>> rlms::minesweeper::neighbors(int x, int y) cons
 }
 
 void rlms::minesweeper::generate_mines(int x, int y) {
+    switch (cfg.engine) {
+    case rng_engine::philox: generate_mines_with<philox4x32>(x, y); break;
+    case rng_engine::splitmix: generate_mines_with<splitmix>(x, y); break;
+    case rng_engine::mt19937: generate_mines_with<std::mt19937>(x, y); break;
+    }
+}
+
+template <typename Engine>
+void rlms::minesweeper::generate_mines_with(int x, int y) {
     if (!cfg.validate()) {
         return;
     }
@@ -80,46 +559,73 @@ void rlms::minesweeper::generate_mines(int x, int y) {
         return;
     }
 
-    // Forbidden cells
-    std::vector<std::pair<int, int>> forb = {
-        {x, y}};
-    for (auto [nx, ny] : neighbors(x, y)) {
-        forb.emplace_back(nx, ny);
-    }
+    // std::mt19937 keeps the single generator and full shuffle of the older
+    // versions, so each attempt places the mines as they did, the
+    // counter-based engines get a stream per attempt
+    constexpr bool compat = std::is_same_v<Engine, std::mt19937>;
 
-    std::mt19937 gen(cfg.seed);
+    Engine gen = compat ? Engine(cfg.seed) : make_stream<Engine>(cfg.seed, 0);
 
-    unsolvable = true;
+    gen_stats.boards++;
+
+    bool accepted = false;
+    bool checked  = false; // Whether the solvability of the attempt is known
+    bool solvable = false;
     for (int i = 0; i < cfg.attempts; i++) {
-        // Reset board completely
+        if constexpr (!compat) {
+            gen = make_stream<Engine>(cfg.seed, i);
+        }
+
+        // Nothing of the last attempt is kept
+        scratch.reset();
+
+        // Reset board completely, the states are already reset by the reset
+        // before the first attempt and the solver after every attempt
         for (int x = 0; x < cfg.width; x++) {
             for (int y = 0; y < cfg.height; y++) {
-                at(x, y) = cell();
+                at(x, y).is_mine = false;
+                at(x, y).n_mines = 0;
             }
         }
 
-        // Create list of allowed positions
-        std::vector<std::pair<int, int>> allowed;
-        allowed.reserve(cfg.width * cfg.height);
-        for (int x = 0; x < cfg.width; ++x) {
-            for (int y = 0; y < cfg.height; ++y) {
-                if (std::find(forb.begin(), forb.end(), std::make_pair(x, y)) == forb.end()) {
-                    allowed.emplace_back(x, y);
+        // Solvable by construction, no need to check it
+        bool forced = false;
+
+        if (cfg.generator == generator_algorithm::constructive) {
+            forced = construct_mines(*this, x, y, gen);
+        } else {
+            // Create list of allowed positions, all but the first click and
+            // its neighbors
+            std::pmr::vector<std::pair<int, int>> allowed(&scratch);
+            allowed.reserve(cfg.width * cfg.height);
+            for (int ax = 0; ax < cfg.width; ++ax) {
+                for (int ay = 0; ay < cfg.height; ++ay) {
+                    if (std::abs(ax - x) > 1 || std::abs(ay - y) > 1) {
+                        allowed.emplace_back(ax, ay);
+                    }
                 }
             }
-        }
 
-        // Make sure we have enough space
-        if (allowed.size() < cfg.mines) {
-            throw std::runtime_error("Not enough free cells to place mines.");
-        }
+            // Make sure we have enough space
+            if (allowed.size() < cfg.mines) {
+                throw std::runtime_error("Not enough free cells to place mines.");
+            }
 
-        std::shuffle(allowed.begin(), allowed.end(), gen);
+            if constexpr (compat) {
+                std::shuffle(allowed.begin(), allowed.end(), gen);
+            } else {
+                // Only the first mines positions are used, shuffle just them
+                for (int j = 0; j < cfg.mines; ++j) {
+                    std::uniform_int_distribution<std::size_t> dist(j, allowed.size() - 1);
+                    std::swap(allowed[j], allowed[dist(gen)]);
+                }
+            }
 
-        // Place mines
-        for (int j = 0; j < cfg.mines; ++j) {
-            auto [mx, my]      = allowed[j];
-            at(mx, my).is_mine = true;
+            // Place mines
+            for (int j = 0; j < cfg.mines; ++j) {
+                auto [mx, my]      = allowed[j];
+                at(mx, my).is_mine = true;
+            }
         }
 
         // Compute neighbor mines count
@@ -137,12 +643,124 @@ void rlms::minesweeper::generate_mines(int x, int y) {
             }
         }
 
-        // Check logically solvability
-        if (logically_solvable(x, y)) {
-            unsolvable = false;
-            break;
+        gen_stats.attempts++;
+        checked  = forced;
+        solvable = forced;
+
+        // Check the 3BV first, it is much cheaper than the solver
+        score = score_board();
+        if (!cfg.filter.accepts_bbbv(score.bbbv)) {
+            gen_stats.bbbv_rejected++;
+            continue;
+        }
+
+        // Check logically solvability, counting the rounds if they are limited
+        if (cfg.filter.checks_rounds()) {
+            solvable = logically_solvable(x, y, &score.rounds);
+        } else {
+            solvable = forced || (solver ? solver->solvable(*this, x, y) : logically_solvable(x, y));
+        }
+        checked = true;
+
+        if (!solvable) {
+            gen_stats.unsolvable++;
+            continue;
+        }
+
+        if (!cfg.filter.accepts_rounds(score.rounds)) {
+            gen_stats.rounds_rejected++;
+            continue;
+        }
+
+        accepted = true;
+        break;
+    }
+
+    // Every attempt was rejected and the board of the last one is kept, which
+    // the filter may have rejected before it was checked
+    if (!accepted) {
+        gen_stats.exhausted++;
+        if (!checked) {
+            solvable = solver ? solver->solvable(*this, x, y) : logically_solvable(x, y);
         }
     }
+
+    unsolvable = !solvable;
+}
+
+template void rlms::minesweeper::generate_mines_with<rlms::philox4x32>(int x, int y);
+template void rlms::minesweeper::generate_mines_with<rlms::splitmix>(int x, int y);
+template void rlms::minesweeper::generate_mines_with<std::mt19937>(int x, int y);
+
+rlms::board_score rlms::minesweeper::score_board() {
+    const int width  = cfg.width;
+    const int height = cfg.height;
+
+    // Nothing else is kept in the arena, so repeated calls do not grow it
+    scratch.reset();
+
+    // Union-find parent of every 0 mines cell, -1 for the other cells
+    std::pmr::vector<int> parent(width * height, -1, &scratch);
+    const auto            find = [&](int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index         = parent[index];
+        }
+        return index;
+    };
+
+    const auto is_zero = [&](int x, int y) { return !board[x][y].is_mine && board[x][y].n_mines == 0; };
+
+    int zeros    = 0;
+    int unions   = 0;
+    int isolated = 0;
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) {
+            const cell &c = board[x][y];
+            if (c.is_mine) {
+                continue;
+            }
+
+            // A numbered cell next to an opening is revealed by it, the others
+            // need a click each
+            if (c.n_mines != 0) {
+                bool opened = false;
+                for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, width - 1) && !opened; nx++) {
+                    for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, height - 1) && !opened; ny++) {
+                        opened = is_zero(nx, ny);
+                    }
+                }
+                isolated += !opened;
+                continue;
+            }
+
+            // Unite the 0 mines cell with the ones before it: the previous
+            // column and the cell above
+            const int index = x * height + y;
+            parent[index]   = index;
+            zeros++;
+
+            const std::pair<int, int> before[] = {{x - 1, y - 1}, {x - 1, y}, {x - 1, y + 1}, {x, y - 1}};
+            for (auto [bx, by] : before) {
+                if (bx < 0 || by < 0 || by >= height || parent[bx * height + by] < 0) {
+                    continue;
+                }
+
+                const int a = find(index);
+                const int b = find(bx * height + by);
+                if (a != b) {
+                    parent[b] = a;
+                    unions++;
+                }
+            }
+        }
+    }
+
+    // Every union merged two regions
+    board_score result;
+    result.openings = zeros - unions;
+    result.bbbv     = result.openings + isolated;
+    return result;
 }
 
 bool rlms::minesweeper::check_won() const {
@@ -158,131 +776,203 @@ bool rlms::minesweeper::check_won() const {
 }
 
 int rlms::minesweeper::cells_flagged() const {
-    int flagged_count = 0;
-    for (int x = 0; x < cfg.width; x++) {
-        for (int y = 0; y < cfg.height; y++) {
-            if (at(x, y).state == cell_state::flagged) {
-                flagged_count++;
+    return flags;
+}
+
+void rlms::minesweeper::set_state(int x, int y, cell_state new_state, change_set *changes) {
+    const cell_state old_state = at(x, y).state;
+    if (old_state == new_state) {
+        return;
+    }
+
+    set_cell_state(x, y, new_state);
+    flags += (new_state == cell_state::flagged) - (old_state == cell_state::flagged);
+    update_frontier(*this, x, y, old_state);
+
+    if (changes) {
+        changes->cells.push_back({x, y, new_state});
+    }
+}
+
+void rlms::minesweeper::set_cell_state(int x, int y, cell_state new_state) {
+    const cell_state old_state = at(x, y).state;
+    at(x, y).state             = new_state;
+
+    // Update the counters of the neighbors
+    const auto is_marked = [](cell_state s) { return s == cell_state::flagged || s == cell_state::qmarked; };
+    const int  hidden    = (new_state == cell_state::hidden) - (old_state == cell_state::hidden);
+    const int  flagged   = (new_state == cell_state::flagged) - (old_state == cell_state::flagged);
+    const int  marked    = is_marked(new_state) - is_marked(old_state);
+
+    for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, cfg.width - 1); nx++) {
+        for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, cfg.height - 1); ny++) {
+            if (nx == x && ny == y) {
+                continue;
             }
+
+            cell &n      = board[nx][ny];
+            n.n_hidden  += hidden;
+            n.n_flagged += flagged;
+            n.n_marked  += marked;
         }
     }
-
-    return flagged_count;
 }
 
-void rlms::minesweeper::reveal(int x, int y) {
-    if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
+void rlms::minesweeper::set_game_state(game_state new_state, change_set *changes) {
+    if (state == new_state) {
         return;
     }
 
-    if (at(x, y).is_mine) {
-        at(x, y).state = cell_state::revealed;
-        state          = game_state::lost;
-        return;
+    state = new_state;
+
+    if (changes) {
+        changes->game_state_changed = true;
     }
+}
 
-    // Does not use recursion
-    std::queue<std::pair<int, int>> queue;
-    queue.emplace(x, y);
+bool rlms::minesweeper::cascading() const {
+    return !wavefront.empty();
+}
 
-    while (!queue.empty()) {
-        auto [cx, cy] = queue.front();
-        queue.pop();
+bool rlms::minesweeper::step_cascade(int max_cells, change_set *changes) {
+    // Does not use recursion
+    for (int processed = 0; !wavefront.empty() && (max_cells <= 0 || processed < max_cells); processed++) {
+        auto [cx, cy]             = wavefront.pop_front();
+        at(cx, cy).in_wavefront = false;
 
         // Cell already revealed, or is flagged/question-marked
         if (at(cx, cy).state != cell_state::hidden) {
             continue;
         }
 
-        at(cx, cy).state = cell_state::revealed;
+        set_state(cx, cy, cell_state::revealed, changes);
 
         // Stop expanding if cell has neighboring mines
         if (at(cx, cy).n_mines != 0) {
             continue;
         }
 
-        // Add hidden neighbors to queue
+        // Add hidden neighbors to the wavefront
         for (auto [nx, ny] : neighbors(cx, cy)) {
             if (at(nx, ny).state == cell_state::hidden) {
-                queue.emplace(nx, ny);
+                push_wavefront(*this, nx, ny);
             }
         }
     }
+
+    if (cascading()) {
+        return true;
+    }
+
+    // The win can only be decided once every cell of the cascade is revealed
+    if (state == game_state::playing && check_won()) {
+        set_game_state(game_state::won, changes);
+    }
+
+    // Apply the clicks made during the cascade, stopping if one starts another
+    while (!cascading() && !pending_clicks.empty()) {
+        const action a = pending_clicks.pop_front();
+
+        switch (a.type) {
+        case action_type::primary: primary_click(a.x, a.y, changes); break;
+        case action_type::secondary: secondary_click(a.x, a.y, changes); break;
+        }
+    }
+
+    return cascading();
 }
 
-void rlms::minesweeper::speed_reveal(int x, int y) {
+void rlms::minesweeper::reveal(int x, int y, change_set *changes) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return;
     }
 
-    // Coords of neighboring cells
-    std::vector<std::pair<int, int>> marked;
-    std::vector<std::pair<int, int>> hidden;
+    if (at(x, y).is_mine) {
+        set_state(x, y, cell_state::revealed, changes);
+        set_game_state(game_state::lost, changes);
+        return;
+    }
+
+    push_wavefront(*this, x, y);
+    step_cascade(cascade_budget, changes);
+}
 
+void rlms::minesweeper::speed_reveal(int x, int y, change_set *changes) {
+    if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
+        return;
+    }
+
+    if (at(x, y).n_marked != at(x, y).n_mines) {
+        return;
+    }
+
+    // Coords of hidden neighboring cells
+    neighbor_list hidden;
     for (auto [nx, ny] : neighbors(x, y)) {
-        if (at(nx, ny).state == cell_state::flagged ||
-            at(nx, ny).state == cell_state::qmarked) {
-            marked.emplace_back(nx, ny);
-        }
         if (at(nx, ny).state == cell_state::hidden) {
             hidden.emplace_back(nx, ny);
         }
     }
 
-    if (marked.size() == at(x, y).n_mines) {
-        for (auto [rx, ry] : hidden) {
-            reveal(rx, ry);
+    // Reveal all hidden neighbors in a single fill sharing one wavefront
+    for (auto [rx, ry] : hidden) {
+        if (at(rx, ry).is_mine) {
+            set_state(rx, ry, cell_state::revealed, changes);
+            set_game_state(game_state::lost, changes);
+        } else {
+            push_wavefront(*this, rx, ry);
         }
     }
+    step_cascade(cascade_budget, changes);
 }
 
-void rlms::minesweeper::toggle(int x, int y) {
+void rlms::minesweeper::toggle(int x, int y, change_set *changes) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return;
     }
 
     if (at(x, y).state == cell_state::hidden) {
-        at(x, y).state = cell_state::flagged;
+        set_state(x, y, cell_state::flagged, changes);
     } else if (at(x, y).state == cell_state::flagged) {
-        at(x, y).state = cell_state::qmarked;
+        set_state(x, y, cell_state::qmarked, changes);
     } else if (at(x, y).state == cell_state::qmarked) {
-        at(x, y).state = cell_state::hidden;
+        set_state(x, y, cell_state::hidden, changes);
     }
 }
 
-void rlms::minesweeper::speed_flag(int x, int y) {
+void rlms::minesweeper::speed_flag(int x, int y, change_set *changes) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return;
     }
 
-    // Coords of neighboring cells
-    std::vector<std::pair<int, int>> hidden;
+    if (at(x, y).n_hidden + at(x, y).n_marked != at(x, y).n_mines) {
+        return;
+    }
 
     for (auto [nx, ny] : neighbors(x, y)) {
         if (at(nx, ny).state != cell_state::revealed) {
-            hidden.emplace_back(nx, ny);
-        }
-    }
-
-    if (hidden.size() == at(x, y).n_mines) {
-        for (auto [rx, ry] : hidden) {
-            at(rx, ry).state = cell_state::flagged;
+            set_state(nx, ny, cell_state::flagged, changes);
         }
     }
 }
 
-void rlms::minesweeper::primary_click(int x, int y) {
+void rlms::minesweeper::primary_click(int x, int y, change_set *changes) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return;
     }
 
+    if (cascading()) {
+        pending_clicks.push_back({action_type::primary, x, y});
+        return;
+    }
+
     if (state == game_state::first_click) {
         generate_mines(x, y);
-        reveal(x, y);
-        state = game_state::playing;
+        set_game_state(game_state::playing, changes);
+        reveal(x, y, changes);
 
-        if (check_won()) {
-            state = game_state::won;
+        if (!cascading() && check_won()) {
+            set_game_state(game_state::won, changes);
         }
 
         return;
@@ -298,89 +988,106 @@ void rlms::minesweeper::primary_click(int x, int y) {
     }
 
     if (at(x, y).is_mine) {
-        at(x, y).state = cell_state::revealed;
-        state          = game_state::lost;
+        set_state(x, y, cell_state::revealed, changes);
+        set_game_state(game_state::lost, changes);
         return;
     }
 
     if (at(x, y).state != cell_state::revealed) {
-        reveal(x, y);
+        reveal(x, y, changes);
     } else if (at(x, y).n_mines > 0) {
-        speed_reveal(x, y);
+        speed_reveal(x, y, changes);
     }
 
-    if (check_won()) {
-        state = game_state::won;
+    if (!cascading() && check_won()) {
+        set_game_state(game_state::won, changes);
     }
 }
 
-void rlms::minesweeper::secondary_click(int x, int y) {
+void rlms::minesweeper::secondary_click(int x, int y, change_set *changes) {
     if (x < 0 || x >= cfg.width || y < 0 || y >= cfg.height) {
         return;
     }
 
+    if (cascading()) {
+        pending_clicks.push_back({action_type::secondary, x, y});
+        return;
+    }
+
     if (state != game_state::playing) {
         return;
     }
 
     if (at(x, y).state != cell_state::revealed) {
-        toggle(x, y);
+        toggle(x, y, changes);
     } else {
-        speed_flag(x, y);
+        speed_flag(x, y, changes);
     }
 
     if (check_won()) {
-        state = game_state::won;
+        set_game_state(game_state::won, changes);
     }
 }
 
-bool rlms::minesweeper::logically_solvable(int x, int y) {
+bool rlms::minesweeper::logically_solvable(int x, int y, int *rounds) {
+    // The deduction needs every reveal to complete at once
+    const int budget = cascade_budget;
+    cascade_budget   = 0;
+
     // Initial reveal
     reveal(x, y);
 
-    // Deduction loop
-    // Beware, never nesters
-    bool progress = true;
+    // Rounds are counted as layers of deductions from the state at the start
+    // of the round, applied once the round has found them all. The fixpoint is
+    // the same as deducing in place, which is faster, so that is done when the
+    // rounds are not counted.
+    if (rounds) {
+        *rounds = deduction_rounds();
+    }
+
+    // Deduction loop over the numbers next to the frontier. Applying a rule
+    // removes cells from the frontier, moving others into their place to be
+    // visited by the next sweep; a sweep without progress visits them all.
+    bool progress = !rounds;
     while (progress) {
         progress = false;
 
-        for (int x = 0; x < cfg.width; x++) {
-            for (int y = 0; y < cfg.height; y++) {
-                if (at(x, y).state != cell_state::hidden) {
-                    continue;
-                }
-
-                // Coords of neighboring cells
-                std::vector<std::pair<int, int>> flagged;
-                std::vector<std::pair<int, int>> hidden;
+        for (std::size_t i = 0; i < frontier.size(); i++) {
+            const int fx = frontier[i] / cfg.height;
+            const int fy = frontier[i] % cfg.height;
 
-                for (auto [nx, ny] : neighbors(x, y)) {
-                    if (at(nx, ny).state == cell_state::flagged) {
-                        flagged.emplace_back(nx, ny);
-                    }
-                    if (at(nx, ny).state == cell_state::hidden) {
-                        hidden.emplace_back(nx, ny);
+            for (int x = std::max(fx - 1, 0); x <= std::min(fx + 1, cfg.width - 1); x++) {
+                for (int y = std::max(fy - 1, 0); y <= std::min(fy + 1, cfg.height - 1); y++) {
+                    // Only the numbers of revealed cells are known to the player
+                    const cell &c = board[x][y];
+                    if (c.state != cell_state::revealed || c.n_hidden == 0) {
+                        continue;
                     }
-                }
 
-                // Rule 1: If the number of neighboring flagged cells equals the
-                // number of neighboring mine cells, then all hidden cells are
-                // safe to be revealed
-                if (flagged.size() == at(x, y).n_mines) {
-                    for (auto [hx, hy] : hidden) {
-                        reveal(hx, hy);
+                    // Rule 1: If the number of neighboring flagged cells equals
+                    // the number of neighboring mine cells, then all hidden
+                    // cells are safe to be revealed
+                    if (c.n_flagged == c.n_mines) {
+                        for (auto [nx, ny] : neighbors(x, y)) {
+                            if (at(nx, ny).state == cell_state::hidden) {
+                                reveal(nx, ny);
+                            }
+                        }
                         progress = true;
+                        continue;
                     }
-                }
 
-                // Rule 2: If the number of neighboring flagged cells plus the
-                // number of neighboring hidden cells equals the number of
-                // neighboring cells that are mine, then all hidden cells are
-                // mines.
-                if (flagged.size() + hidden.size() == at(x, y).n_mines) {
-                    for (auto [hx, hy] : hidden) {
-                        at(hx, hy).state = cell_state::flagged;
-                        progress         = true;
+                    // Rule 2: If the number of neighboring flagged cells plus
+                    // the number of neighboring hidden cells equals the number
+                    // of neighboring cells that are mine, then all hidden cells
+                    // are mines.
+                    if (c.n_flagged + c.n_hidden == c.n_mines) {
+                        for (auto [nx, ny] : neighbors(x, y)) {
+                            if (at(nx, ny).state == cell_state::hidden) {
+                                set_state(nx, ny, cell_state::flagged);
+                            }
+                        }
+                        progress = true;
                     }
                 }
             }
@@ -391,11 +1098,66 @@ bool rlms::minesweeper::logically_solvable(int x, int y) {
     bool solved = check_won();
 
     // Reset the board's cell state.
-    for (int x = 0; x < cfg.width; x++) {
-        for (int y = 0; y < cfg.height; y++) {
-            at(x, y).state = cell_state::hidden;
-        }
-    }
+    reset_states();
 
+    cascade_budget = budget;
     return solved;
+}
+
+int rlms::minesweeper::deduction_rounds() {
+    scratch.reset();
+
+    // Numbers a rule applies to, as cell index * 2 + rule
+    std::pmr::vector<int> deductions(&scratch);
+
+    int rounds = 0;
+    while (true) {
+        // Find the deductions of the round without changing anything
+        deductions.clear();
+        for (std::size_t i = 0; i < frontier.size(); i++) {
+            const int fx = frontier[i] / cfg.height;
+            const int fy = frontier[i] % cfg.height;
+
+            for (int x = std::max(fx - 1, 0); x <= std::min(fx + 1, cfg.width - 1); x++) {
+                for (int y = std::max(fy - 1, 0); y <= std::min(fy + 1, cfg.height - 1); y++) {
+                    const cell &c = board[x][y];
+                    if (c.state != cell_state::revealed || c.n_hidden == 0) {
+                        continue;
+                    }
+
+                    // Rule 1: all hidden neighbors are safe, rule 2: all
+                    // hidden neighbors are mines, as in logically_solvable
+                    if (c.n_flagged == c.n_mines) {
+                        deductions.push_back((x * cfg.height + y) * 2);
+                    } else if (c.n_flagged + c.n_hidden == c.n_mines) {
+                        deductions.push_back((x * cfg.height + y) * 2 + 1);
+                    }
+                }
+            }
+        }
+
+        if (deductions.empty()) {
+            return rounds;
+        }
+        rounds++;
+
+        // A number may be found from several frontier cells, and the cells a
+        // deduction covers may already be resolved by another one
+        for (const int deduction : deductions) {
+            const int x = deduction / 2 / cfg.height;
+            const int y = deduction / 2 % cfg.height;
+
+            for (auto [nx, ny] : neighbors(x, y)) {
+                if (at(nx, ny).state != cell_state::hidden) {
+                    continue;
+                }
+
+                if (deduction % 2 == 0) {
+                    reveal(nx, ny);
+                } else {
+                    set_state(nx, ny, cell_state::flagged);
+                }
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -4,31 +4,85 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <memory_resource>
 #include <random>
+#include <utility>
 #include <vector>
 
+#include "rlmsarena.hpp"
+#include "rlmsfrontier.hpp"
+#include "rlmsrng.hpp"
+
 namespace rlms {
 
+class tiled_solver;
+
+/// Random number engine used to generate the mines.
+enum class rng_engine {
+    philox,   ///< Philox4x32-10, counter-based. Every attempt has its own stream.
+    splitmix, ///< SplitMix64, counter-based. Every attempt has its own stream.
+    mt19937   ///< std::mt19937 seeded with the low 32 bits of the seed, shared by all attempts (the engine of older versions).
+};
+
+/// Mine generation algorithm.
+enum class generator_algorithm {
+    shuffle,     ///< Place mines randomly, retry until the board is logically solvable.
+    constructive ///< Grow the deduced region from the first click, placing mines so that every step stays forced.
+};
+
+/// Acceptance filter of the generated boards by difficulty. Attempts outside
+/// the limits are rejected like unsolvable ones. Limits of 0 are not checked.
+/// The rounds are those of minesweeper::deduction_rounds.
+struct difficulty_filter {
+    int min_bbbv   = 0; ///< Minimum 3BV.
+    int max_bbbv   = 0; ///< Maximum 3BV.
+    int min_rounds = 0; ///< Minimum deduction rounds.
+    int max_rounds = 0; ///< Maximum deduction rounds.
+
+    /// Whether the rounds are limited, which needs them counted.
+    bool checks_rounds() const {
+        return min_rounds > 0 || max_rounds > 0;
+    }
+
+    bool accepts_bbbv(int bbbv) const {
+        return (min_bbbv <= 0 || bbbv >= min_bbbv) && (max_bbbv <= 0 || bbbv <= max_bbbv);
+    }
+
+    bool accepts_rounds(int rounds) const {
+        return (min_rounds <= 0 || rounds >= min_rounds) && (max_rounds <= 0 || rounds <= max_rounds);
+    }
+};
+
 /// Minesweeper board configuration.
 struct config {
-    int width    = 8;   ///< Board width (number of columns).
-    int height   = 8;   ///< Board height (number of rows).
-    int mines    = 10;  ///< Number of mines to generate on the board.
-    int seed     = -1;  ///< RNG seed. Use -1 to randomize seed.
-    int attempts = 100; ///< Max generation attempts for logically solvable board.
+    int           width    = 8;                  ///< Board width (number of columns).
+    int           height   = 8;                  ///< Board height (number of rows).
+    int           mines    = 10;                 ///< Number of mines to generate on the board.
+    std::uint64_t seed     = 0;                  ///< RNG seed.
+    int           attempts = 100;                ///< Max generation attempts for logically solvable board.
+    rng_engine    engine   = rng_engine::philox; ///< RNG engine to generate the mines with.
+
+    generator_algorithm generator = generator_algorithm::shuffle; ///< Mine generation algorithm.
+    difficulty_filter   filter    = {};                           ///< Difficulty the generated board must have.
 
     void randomize_seed() {
         std::random_device rd;
-        seed = rd();
+        seed = (std::uint64_t(rd()) << 32) | rd();
     }
 
     /// Validate the board configuration.
-    bool validate() {
+    bool validate() const {
         if (width < 1 || height < 1 || attempts < 1) {
             return false;
         }
 
-        if (mines > width * height - 9) {
+        if (mines < 0 || mines > width * height - 9) {
+            return false;
+        }
+
+        if ((filter.max_bbbv > 0 && filter.max_bbbv < filter.min_bbbv) || (filter.max_rounds > 0 && filter.max_rounds < filter.min_rounds)) {
             return false;
         }
 
@@ -47,11 +101,153 @@ enum class cell_state {
 };
 
 /// Minesweeper cell.
+/// @note The neighbor state counters are kept up to date by
+///       minesweeper::set_state, never change the state directly.
 struct cell {
-    bool is_mine = false; ///< True if the cell is a mine.
-    int  n_mines = 0;     ///< Number of neighboring mines.
+    bool is_mine      = false; ///< True if the cell is a mine.
+    bool in_wavefront = false; ///< True if the cell is queued in the reveal cascade wavefront.
+    int  n_mines      = 0;     ///< Number of neighboring mines.
 
     cell_state state = cell_state::hidden; ///< State of the cell.
+
+    std::uint8_t n_hidden  = 0; ///< Number of hidden (unmarked) neighbors.
+    std::uint8_t n_flagged = 0; ///< Number of flagged neighbors.
+    std::uint8_t n_marked  = 0; ///< Number of flagged or question-marked neighbors.
+};
+
+/// Change of a single cell's state.
+struct cell_change {
+    int        x;     ///< Cell x coordinate.
+    int        y;     ///< Cell y coordinate.
+    cell_state state; ///< New state of the cell.
+};
+
+/// Changes made by the mutating operations, to allow updating the dependents
+/// (renderers, solvers, etc.) incrementally instead of rescanning the board.
+/// @note The operations only append to it. Clear it before reusing.
+struct change_set {
+    std::vector<cell_change> cells;                      ///< Changed cells, in the order of change.
+    bool                     game_state_changed = false; ///< Whether the game state has changed.
+
+    /// Clear the changes, keeping the capacity.
+    void clear() {
+        cells.clear();
+        game_state_changed = false;
+    }
+};
+
+/// Coordinates of up to 8 cells (the neighbors of a cell), stored inline
+/// without allocating.
+struct neighbor_list {
+    std::array<std::pair<int, int>, 8> cells;     ///< The cells, only the first count are valid.
+    int                                count = 0; ///< Number of cells.
+
+    void emplace_back(int x, int y) {
+        cells[count++] = {x, y};
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    std::size_t size() const { return count; }
+    bool        empty() const { return count == 0; }
+
+    std::pair<int, int>       &operator[](std::size_t i) { return cells[i]; }
+    const std::pair<int, int> &operator[](std::size_t i) const { return cells[i]; }
+
+    std::pair<int, int>       *begin() { return cells.data(); }
+    std::pair<int, int>       *end() { return cells.data() + count; }
+    const std::pair<int, int> *begin() const { return cells.data(); }
+    const std::pair<int, int> *end() const { return cells.data() + count; }
+};
+
+/// FIFO queue on a single buffer.
+/// @note Unlike std::deque, it stops allocating once the buffer has grown to
+///       the working size. The popped front is compacted away once it is at
+///       least half of the buffer.
+template <typename T>
+class fifo_queue {
+public:
+    template <typename... Args>
+    void emplace_back(Args &&...args) {
+        items.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void push_back(const T &item) {
+        items.push_back(item);
+    }
+
+    T pop_front() {
+        const T front = items[head++];
+
+        if (head == items.size()) {
+            clear();
+        } else if (head >= 64 && head * 2 >= items.size()) {
+            items.erase(items.begin(), items.begin() + head);
+            head = 0;
+        }
+
+        return front;
+    }
+
+    void clear() {
+        items.clear();
+        head = 0;
+    }
+
+    std::size_t size() const { return items.size() - head; }
+    bool        empty() const { return head == items.size(); }
+
+    auto begin() const { return items.begin() + head; }
+    auto end() const { return items.end(); }
+
+private:
+    std::vector<T> items;
+    std::size_t    head = 0; ///< Index of the front.
+};
+
+/// FIFO queue of cell coordinates.
+using cell_queue = fifo_queue<std::pair<int, int>>;
+
+/// Player action type.
+enum class action_type : std::uint8_t {
+    primary,  ///< Primary click (reveal or speed reveal).
+    secondary ///< Secondary click (flag or speed flag).
+};
+
+/// Player action on the board.
+struct action {
+    action_type type = action_type::primary;
+    int         x    = 0;
+    int         y    = 0;
+};
+
+/// Difficulty score of a board.
+struct board_score {
+    int bbbv     = 0;  ///< 3BV, the least clicks to clear the board: the openings plus the numbered cells next to none.
+    int openings = 0;  ///< Connected regions of 0 mines cells, each cleared with a single click.
+    int rounds   = -1; ///< Deduction rounds to solve the board, -1 if not counted.
+};
+
+/// Mine generation statistics.
+struct generation_stats {
+    std::uint64_t boards          = 0; ///< Boards generated.
+    std::uint64_t attempts        = 0; ///< Attempts made.
+    std::uint64_t unsolvable      = 0; ///< Attempts rejected as logically unsolvable.
+    std::uint64_t bbbv_rejected   = 0; ///< Attempts rejected by the 3BV limits.
+    std::uint64_t rounds_rejected = 0; ///< Attempts rejected by the deduction rounds limits.
+    std::uint64_t exhausted       = 0; ///< Boards with every attempt rejected.
+
+    /// Merge other statistics into this.
+    void merge(const generation_stats &other) {
+        boards          += other.boards;
+        attempts        += other.attempts;
+        unsolvable      += other.unsolvable;
+        bbbv_rejected   += other.bbbv_rejected;
+        rounds_rejected += other.rounds_rejected;
+        exhausted       += other.exhausted;
+    }
 };
 
 /// Minesweeper game state.
@@ -64,10 +260,62 @@ enum class game_state {
 
 /// The Minesweeper.
 /// @note The member functions will ignore provided invalid coordinates.
+/// @note The mutating member functions optionally append the changes they make
+///       to the provided change set.
+/// @note Gameplay does not allocate once the board is initialized and its
+///       queues (wavefront, pending_clicks) have grown to the working size,
+///       and mine generation takes all of its scratch memory from the scratch
+///       arena, which is reset every attempt.
 struct minesweeper {
     config     cfg;                ///< Minesweeper board configuration.
     game_state state;              ///< Minesweeper game state.
     bool       unsolvable = false; ///< Whether the board is logically unsolvable.
+    int        flags      = 0;     ///< Number of flagged cells, kept up to date by set_state.
+
+    /// Max cells a reveal cascade processes per step, 0 for unlimited. When
+    /// limited, a reveal only starts the cascade and step_cascade advances it.
+    int cascade_budget = 0;
+
+    /// Cells the reveal cascade processes next, in order (the wavefront of the
+    /// flood fill). Empty when no cascade is in progress.
+    /// @note Every cell is queued at most once (cell::in_wavefront), but may
+    ///       no longer be hidden, skip cells that are not.
+    cell_queue wavefront;
+
+    /// Clicks that arrived while a cascade is in progress, applied in order
+    /// once the cascade ends.
+    fifo_queue<action> pending_clicks;
+
+    /// Hidden cells next to revealed cells (the frontier), as cell indices
+    /// x * height + y, kept up to date by set_state. Its components group the
+    /// cells that share revealed neighbors, so cells of different components
+    /// never share a number.
+    /// @note The hidden neighbors of revealed 0 mines cells are left out, as
+    ///       the reveal cascade reveals them, so it is only complete when no
+    ///       cascade is in progress. set_cell_state does not update it,
+    ///       reset_states clears it.
+    frontier_set frontier;
+
+    /// Scratch memory of the mine generation. A copy of the board gets an
+    /// empty arena of its own.
+    arena_resource scratch;
+
+    /// Score of the generated board. Rounds are only counted when the
+    /// difficulty filter limits them.
+    board_score score;
+
+    /// Statistics of all the mine generations of the board.
+    generation_stats gen_stats;
+
+    /// Solver to check the generated boards with on multiple threads, or
+    /// nullptr to check them with logically_solvable.
+    tiled_solver *solver = nullptr;
+
+    minesweeper() = default;
+
+    /// Create the minesweeper with the scratch arena allocating its memory
+    /// from the upstream resource.
+    explicit minesweeper(std::pmr::memory_resource *upstream);
 
     /// Minesweeper board, the grid of cells.
     /// @note It is neither column-major nor row-major. The access pattern is
@@ -90,43 +338,104 @@ struct minesweeper {
     /// configuration.
     void reset();
 
+    /// Hide all the cells and initialize their neighbor state counters.
+    void reset_states();
+
+    /// Component label of the frontier cell, or -1 if it is not on the
+    /// frontier. Cells of the same component have the same label.
+    /// @note Rebuilds the components first, in O(frontier), if cells left the
+    ///       frontier since the last rebuild.
+    int frontier_component(int x, int y);
+
     /// Obtain the neighboring cells of the given cell coordinates.
-    std::vector<std::pair<int, int>> neighbors(int x, int y) const;
+    neighbor_list neighbors(int x, int y) const;
 
     /// Generate mines in the board in a logically solvable manner by excluding
-    /// the specified coordinates and its neighbors.
+    /// the specified coordinates and its neighbors. Uses the configured engine.
+    /// Attempts outside the difficulty filter are rejected, the 3BV being
+    /// checked before the (much slower) solver. When every attempt is
+    /// rejected, the board of the last one is kept, and unsolvable tells
+    /// whether that board is logically solvable.
+    /// @note Limiting the rounds needs them counted by logically_solvable,
+    ///       which is then used instead of the tiled solver.
     void generate_mines(int x, int y);
 
+    /// Generate mines using the engine. Every attempt uses the stream of the
+    /// seed with attempt number as the stream id.
+    /// @note Instantiated for philox4x32, splitmix and std::mt19937.
+    template <typename Engine>
+    void generate_mines_with(int x, int y);
+
+    /// Score the 3BV of the board from the mines, in linear time, labeling the
+    /// regions of 0 mines cells with union-find. Does not count the rounds.
+    /// @note Resets the scratch arena and takes its memory from it, nothing
+    ///       allocated from the arena must be in use.
+    board_score score_board();
+
     /// Check if all the non-mine cells are revealed.
     bool check_won() const;
 
     /// Number of cells flagged.
     int cells_flagged() const;
 
-    /// Reveal the cell and non-0 mines neighbors.
-    void reveal(int x, int y);
+    /// Set the cell state, recording the change if it differs. Updates the
+    /// neighbor state counters of the neighbors, the flag count and the
+    /// frontier.
+    void set_state(int x, int y, cell_state new_state, change_set *changes = nullptr);
+
+    /// Set the cell state and update the neighbor state counters of its
+    /// neighbors, without touching anything outside its 3x3 neighborhood (not
+    /// even the flag count). Used by the tiled solver, use set_state instead.
+    void set_cell_state(int x, int y, cell_state new_state);
 
-    /// Perform speed reveal on the revealed cell.
-    void speed_reveal(int x, int y);
+    /// Set the game state, recording the change if it differs.
+    void set_game_state(game_state new_state, change_set *changes = nullptr);
+
+    /// Whether a reveal cascade is in progress.
+    bool cascading() const;
+
+    /// Advance the reveal cascade by up to max_cells wavefront cells (0 for
+    /// all), as a single multi-source flood fill through 0 mines neighbors.
+    /// When the cascade ends, checks for the win and applies the pending
+    /// clicks. Returns whether the cascade is still in progress.
+    /// @note The wavefront cells must not be mines.
+    bool step_cascade(int max_cells, change_set *changes = nullptr);
+
+    /// Reveal the cell and non-0 mines neighbors. Processes up to
+    /// cascade_budget cells of the cascade.
+    void reveal(int x, int y, change_set *changes = nullptr);
+
+    /// Perform speed reveal on the revealed cell. Processes up to
+    /// cascade_budget cells of the cascade.
+    void speed_reveal(int x, int y, change_set *changes = nullptr);
 
     /// Toggle the cell state (hidden -> flagged -> qmarked -> hidden).
-    void toggle(int x, int y);
+    void toggle(int x, int y, change_set *changes = nullptr);
 
     /// Speed flag neighbor cells.
-    void speed_flag(int x, int y);
+    void speed_flag(int x, int y, change_set *changes = nullptr);
 
     /// Primary click (usually left click) on the board. This will reveal or
-    /// performs speed reveal on the cell.
-    void primary_click(int x, int y);
+    /// performs speed reveal on the cell. Queued while cascading.
+    void primary_click(int x, int y, change_set *changes = nullptr);
 
     /// Secondary click (usually right click) on the board. This will flag or
-    /// performs speed flag on the cell.
-    void secondary_click(int x, int y);
+    /// performs speed flag on the cell. Queued while cascading.
+    void secondary_click(int x, int y, change_set *changes = nullptr);
 
-    /// Try to solve the board logically from the first click coords.
+    /// Try to solve the board logically from the first click coords. Counts
+    /// the deduction rounds into rounds if given, see deduction_rounds.
     /// @note Do not call it during gameplay, as it mutates state and destroys
     ///       it later. This is only used when generating the board.
-    bool logically_solvable(int x, int y);
+    bool logically_solvable(int x, int y, int *rounds = nullptr);
+
+    /// Deduce from the revealed numbers until nothing is left to deduce, in
+    /// rounds: every round finds all the deductions the state at its start
+    /// allows, then applies them. Returns the number of rounds that deduced
+    /// anything, which depends only on the board.
+    /// @note Resets the scratch arena and takes its memory from it. Used by
+    ///       logically_solvable, after the initial reveal.
+    int deduction_rounds();
 };
 
 }; // namespace rlms
@@ -0,0 +1,113 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include "rlmsarena.hpp"
+
+namespace {
+
+/// Alignment of the block, enough for any scalar type.
+constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+/// Smallest block allocated when growing.
+constexpr std::size_t min_block_size = 4096;
+
+} // namespace
+
+rlms::arena_resource::arena_resource(std::pmr::memory_resource *upstream)
+    : upstream(upstream) {}
+
+rlms::arena_resource::~arena_resource() {
+    release();
+}
+
+rlms::arena_resource::arena_resource(const arena_resource &other)
+    : upstream(other.upstream) {}
+
+rlms::arena_resource &rlms::arena_resource::operator=(const arena_resource &other) {
+    if (this != &other) {
+        release();
+
+        upstream = other.upstream;
+        block    = nullptr;
+        used     = 0;
+        needed   = 0;
+        overflows.clear();
+        counters = {};
+    }
+    return *this;
+}
+
+void rlms::arena_resource::reset() {
+    for (const auto &o : overflows) {
+        upstream->deallocate(o.p, o.bytes, o.alignment);
+    }
+
+    // Grow the block to fit everything the last round needed
+    if (!overflows.empty()) {
+        if (block) {
+            upstream->deallocate(block, counters.block_size, block_alignment);
+        }
+
+        counters.block_size = std::max(min_block_size, std::bit_ceil(needed));
+        block               = static_cast<std::byte *>(upstream->allocate(counters.block_size, block_alignment));
+        counters.upstream_allocations++;
+    }
+
+    overflows.clear();
+    used   = 0;
+    needed = 0;
+    counters.resets++;
+}
+
+const rlms::arena_stats &rlms::arena_resource::stats() const {
+    return counters;
+}
+
+std::pmr::memory_resource *rlms::arena_resource::upstream_resource() const {
+    return upstream;
+}
+
+void rlms::arena_resource::release() {
+    for (const auto &o : overflows) {
+        upstream->deallocate(o.p, o.bytes, o.alignment);
+    }
+
+    if (block) {
+        upstream->deallocate(block, counters.block_size, block_alignment);
+    }
+}
+
+void *rlms::arena_resource::do_allocate(std::size_t bytes, std::size_t alignment) {
+    counters.allocations++;
+    needed        += bytes + alignment;
+    counters.peak  = std::max(counters.peak, needed);
+
+    if (block) {
+        const std::uintptr_t base    = reinterpret_cast<std::uintptr_t>(block);
+        const std::uintptr_t current = base + used;
+        const std::uintptr_t aligned = (current + alignment - 1) & ~std::uintptr_t(alignment - 1);
+
+        if (aligned + bytes <= base + counters.block_size) {
+            used = aligned + bytes - base;
+            return reinterpret_cast<void *>(aligned);
+        }
+    }
+
+    void *p = upstream->allocate(bytes, alignment);
+    counters.upstream_allocations++;
+    overflows.push_back({p, bytes, alignment});
+    return p;
+}
+
+void rlms::arena_resource::do_deallocate(void *, std::size_t, std::size_t) {
+    // Monotonic, memory is only released on reset
+}
+
+bool rlms::arena_resource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
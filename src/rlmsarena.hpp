@@ -0,0 +1,72 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace rlms {
+
+/// Arena allocation statistics.
+struct arena_stats {
+    std::uint64_t allocations          = 0; ///< Allocations served by the arena.
+    std::uint64_t upstream_allocations = 0; ///< Allocations made from the upstream resource.
+    std::uint64_t resets               = 0; ///< Number of resets.
+    std::size_t   block_size           = 0; ///< Current block size in bytes.
+    std::size_t   peak                 = 0; ///< Most bytes used between two resets.
+};
+
+/// Resettable monotonic arena.
+/// @note Allocations bump a pointer in a single block and deallocations do
+///       nothing. Allocations that do not fit the block go to the upstream
+///       resource until the next reset, which grows the block to fit them
+///       all, so a repeating workload stops allocating from the upstream.
+/// @note A copy is a fresh, empty arena on the same upstream resource, nothing
+///       allocated from the original is shared.
+class arena_resource : public std::pmr::memory_resource {
+public:
+    explicit arena_resource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+
+    ~arena_resource() override;
+
+    arena_resource(const arena_resource &other);
+    arena_resource &operator=(const arena_resource &other);
+
+    /// Release everything allocated since the last reset. Containers using
+    /// the arena must not be used afterwards.
+    void reset();
+
+    /// Allocation statistics.
+    const arena_stats &stats() const;
+
+    /// Upstream resource of the block and the overflow allocations.
+    std::pmr::memory_resource *upstream_resource() const;
+
+private:
+    /// Return the block and the overflow allocations to the upstream.
+    void release();
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void  do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+    bool  do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+    /// Allocation that did not fit the block.
+    struct overflow {
+        void       *p;
+        std::size_t bytes;
+        std::size_t alignment;
+    };
+
+    std::pmr::memory_resource *upstream;
+    std::byte                 *block  = nullptr;
+    std::size_t                used   = 0; ///< Bytes used in the block.
+    std::size_t                needed = 0; ///< Bytes needed since the last reset, including the overflows.
+    std::vector<overflow>      overflows;
+    arena_stats                counters;
+};
+
+}; // namespace rlms
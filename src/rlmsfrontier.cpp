@@ -0,0 +1,73 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <numeric>
+#include <utility>
+
+#include "rlmsfrontier.hpp"
+
+void rlms::frontier_set::resize(int n_cells) {
+    cells.clear();
+    position.assign(n_cells, -1);
+    parent.resize(n_cells);
+    std::iota(parent.begin(), parent.end(), 0);
+    stale = false;
+}
+
+void rlms::frontier_set::insert(int index) {
+    if (position[index] >= 0) {
+        return;
+    }
+
+    // An erased cell may still link members to their root, so it keeps its
+    // parent, merging it with its old component until the next reset. Cells
+    // never linked are their own parent already.
+    if (position[index] == -2) {
+        stale = true;
+    }
+
+    position[index] = cells.size();
+    cells.push_back(index);
+}
+
+void rlms::frontier_set::erase(int index) {
+    const int pos = position[index];
+    if (pos < 0) {
+        return;
+    }
+
+    // Move the last member into the hole
+    const int last  = cells.back();
+    cells[pos]      = last;
+    position[last]  = pos;
+    position[index] = -2;
+    cells.pop_back();
+
+    stale = true;
+}
+
+int rlms::frontier_set::find(int index) const {
+    // Path halving
+    while (parent[index] != index) {
+        parent[index] = parent[parent[index]];
+        index         = parent[index];
+    }
+    return index;
+}
+
+void rlms::frontier_set::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a != b) {
+        parent[b] = a;
+    }
+}
+
+void rlms::frontier_set::reset_components() {
+    // No member links through the erased cells anymore
+    for (int index : cells) {
+        parent[index] = index;
+    }
+    stale = false;
+}
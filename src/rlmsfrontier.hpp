@@ -0,0 +1,62 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace rlms {
+
+/// Set of cell indices with O(1) insert, erase and lookup, and connected
+/// component labels over its members.
+/// @note The members are kept in a dense array for fast iteration, with the
+///       position of every cell in it. Erasing moves the last member into
+///       the erased position. The components are kept with union-find, which
+///       can only merge them: once a member is erased, components it split
+///       stay merged, and are stale until reset_components puts every member
+///       back in its own component to be united again.
+class frontier_set {
+public:
+    /// Resize for the number of cells and clear.
+    void resize(int n_cells);
+
+    bool contains(int index) const { return position[index] >= 0; }
+
+    /// Add the cell as its own component (or in its old one, if it was a
+    /// member since the last reset_components). Does nothing if it is a member.
+    void insert(int index);
+
+    /// Remove the cell. Does nothing if it is not a member.
+    void erase(int index);
+
+    /// Component label of the member, the same for all members of a component.
+    int find(int index) const;
+
+    /// Merge the components of the members.
+    void unite(int a, int b);
+
+    /// Whether members were erased (or inserted again) since the last
+    /// reset_components, so components may be merged that are not connected.
+    bool components_stale() const { return stale; }
+
+    /// Put every member back in its own component.
+    void reset_components();
+
+    std::size_t size() const { return cells.size(); }
+    bool        empty() const { return cells.empty(); }
+
+    int operator[](std::size_t i) const { return cells[i]; }
+
+    auto begin() const { return cells.begin(); }
+    auto end() const { return cells.end(); }
+
+private:
+    std::vector<int>         cells;         ///< Members, in no particular order.
+    std::vector<int>         position;      ///< Position of every cell in cells, -1 if it is not a member, -2 if erased.
+    mutable std::vector<int> parent;        ///< Union-find parent of every cell, compressed by find.
+    bool                     stale = false; ///< Whether the components may be stale.
+};
+
+}; // namespace rlms
@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 
 #include "rlmsg.hpp"
 
@@ -19,6 +21,37 @@ Texture rlmsg::bomb;
 Texture rlmsg::flag;
 Texture rlmsg::crossMark;
 
+namespace {
+
+/// Color of the cell's texel in the board texture.
+Color GetCellPixel(const rlms::minesweeper &ms, const rlms::cell &cell) {
+    using namespace rlms;
+    using namespace rlmsg;
+
+    const bool gameOver = ms.state == game_state::won || ms.state == game_state::lost;
+
+    switch (cell.state) {
+    case cell_state::revealed:
+        if (cell.is_mine) return incorrect;
+        if (cell.n_mines != 0) return GetMineNumberColor(cell.n_mines);
+        return isDarkTheme ? tileShadeDark : tileGlareLight;
+    case cell_state::flagged:
+        return gameOver && !cell.is_mine ? incorrect : pixelFlag;
+    case cell_state::qmarked:
+        return pixelQmark;
+    case cell_state::hidden:
+        if (gameOver && cell.is_mine) return pixelMine;
+        return isDarkTheme ? tileDark : tileLight;
+    }
+    return BLANK;
+}
+
+/// Changed cells up to which the texels are uploaded one by one, instead of
+/// as the rectangle bounding all of them.
+constexpr std::size_t maxTexelUpdates = 64;
+
+} // namespace
+
 Color rlmsg::ColorFromHSLA(float hue, float saturation, float lightness, float alpha) {
     hue        = std::fmod(std::fmod(hue, 360.0f) + 360.0f, 360.0f);
     saturation = std::clamp(saturation, 0.0f, 1.0f);
@@ -64,13 +97,17 @@ Color rlmsg::ColorFromHSLA(float hue, float saturation, float lightness, float a
     return color;
 }
 
+Rectangle rlmsg::ShrinkRec(Rectangle rec, float shrink) {
+    return {rec.x + shrink, rec.y + shrink, rec.width - shrink * 2.0f, rec.height - shrink * 2.0f};
+}
+
 void rlmsg::DrawTextCentered(Font font, const char *text, Rectangle bounds, float fontSize, float spacing, Color tint) {
-    Vector2 m = MeasureTextEx(font, text, fontSize, spacing);
-    DrawTextEx(font, text, {bounds.x + std::floor((bounds.width - m.x) / 2.0f), bounds.y + std::floor((bounds.height - m.y) / 2.0f)}, fontSize, spacing, tint);
+    Vector2 m = GetRenderer().MeasureTextEx(font, text, fontSize, spacing);
+    GetRenderer().DrawTextEx(font, text, {bounds.x + std::floor((bounds.width - m.x) / 2.0f), bounds.y + std::floor((bounds.height - m.y) / 2.0f)}, fontSize, spacing, tint);
 }
 
 void rlmsg::DrawTextureDest(Texture texture, Rectangle dest, Color tint) {
-    DrawTexturePro(texture, {0.0f, 0.0f, (float)texture.width, (float)texture.height}, dest, {}, 0.0f, tint);
+    GetRenderer().DrawTexturePro(texture, {0.0f, 0.0f, (float)texture.width, (float)texture.height}, dest, {}, 0.0f, tint);
 }
 
 Color rlmsg::GetMineNumberColor(int number) {
@@ -122,25 +159,268 @@ void rlmsg::DrawBeveledRectangleInv(Rectangle rec, float thickness) {
 }
 
 void rlmsg::DrawBeveledRectanglePro(Rectangle rec, float thickness, Color glare, Color mid, Color shade) {
-    DrawRectangleRec({rec.x, rec.y, rec.width - thickness, rec.height - thickness}, glare);
-    DrawTriangle({rec.x + rec.width, rec.y}, {rec.x + rec.width - thickness, rec.y}, {rec.x + rec.width - thickness, rec.y + thickness}, glare);
-    DrawTriangle({rec.x + rec.width - thickness, rec.y + thickness}, {rec.x + rec.width, rec.y + thickness}, {rec.x + rec.width, rec.y}, shade);
-    DrawRectangleRec({rec.x + thickness, rec.y + thickness, rec.width - thickness, rec.height - thickness}, shade);
-    DrawTriangle({rec.x, rec.y + rec.height}, {rec.x + thickness, rec.y + rec.height}, {rec.x + thickness, rec.y + rec.height - thickness}, shade);
-    DrawTriangle({rec.x + thickness, rec.y + rec.height - thickness}, {rec.x, rec.y + rec.height - thickness}, {rec.x, rec.y + rec.height}, glare);
-    DrawRectangleRec({rec.x + thickness, rec.y + thickness, rec.width - thickness * 2.0f, rec.height - thickness * 2.0f}, mid);
+    Renderer &renderer = GetRenderer();
+    renderer.DrawRectangleRec({rec.x, rec.y, rec.width - thickness, rec.height - thickness}, glare);
+    renderer.DrawTriangle({rec.x + rec.width, rec.y}, {rec.x + rec.width - thickness, rec.y}, {rec.x + rec.width - thickness, rec.y + thickness}, glare);
+    renderer.DrawTriangle({rec.x + rec.width - thickness, rec.y + thickness}, {rec.x + rec.width, rec.y + thickness}, {rec.x + rec.width, rec.y}, shade);
+    renderer.DrawRectangleRec({rec.x + thickness, rec.y + thickness, rec.width - thickness, rec.height - thickness}, shade);
+    renderer.DrawTriangle({rec.x, rec.y + rec.height}, {rec.x + thickness, rec.y + rec.height}, {rec.x + thickness, rec.y + rec.height - thickness}, shade);
+    renderer.DrawTriangle({rec.x + thickness, rec.y + rec.height - thickness}, {rec.x, rec.y + rec.height - thickness}, {rec.x, rec.y + rec.height}, glare);
+    renderer.DrawRectangleRec({rec.x + thickness, rec.y + thickness, rec.width - thickness * 2.0f, rec.height - thickness * 2.0f}, mid);
 }
 
 void rlmsg::DrawLEDText(const std::string &text, Vector2 position, float fontSize) {
-    float width = MeasureTextEx(font48, "M", fontSize, 0.0f).x;
+    float width = GetRenderer().MeasureTextEx(font48, "M", fontSize, 0.0f).x;
     for (std::size_t i = 0; i < text.size(); i++) {
-        const char      c      = text[i];
+        const char      c[2]   = {text[i], '\0'};
         const Rectangle bounds = {position.x + i * width, position.y, width, fontSize};
-        DrawRectangleRec(bounds, isDarkTheme ? ledBgDark : ledBgLight);
-        DrawTextCentered(font48, TextFormat("%c", c), bounds, fontSize, 0.0f, isDarkTheme ? ledDark : ledLight);
+        GetRenderer().DrawRectangleRec(bounds, isDarkTheme ? ledBgDark : ledBgLight);
+        DrawTextCentered(font48, c, bounds, fontSize, 0.0f, isDarkTheme ? ledDark : ledLight);
     }
 }
 
 Vector2 rlmsg::MeasureLEDText(const std::string &text, float fontSize) {
-    return {MeasureTextEx(font48, "M", fontSize, 0.0f).x * text.size(), fontSize};
+    return {GetRenderer().MeasureTextEx(font48, "M", fontSize, 0.0f).x * text.size(), fontSize};
+}
+
+rlmsg::Layout rlmsg::ComputeLayout(Rectangle screen, int boardWidth, int boardHeight) {
+    Layout layout;
+
+    // Main box
+    layout.screenBox  = screen;
+    layout.screenArea = ShrinkRec(layout.screenBox, bevelThick);
+
+    // Top panel
+    layout.panelBox  = {bevelThick, bevelThick, layout.screenBox.width - bevelThick * 2.0f, panelHeight};
+    layout.panelArea = ShrinkRec(layout.panelBox, bevelThick);
+
+    // Smiley
+    layout.smileyBox  = {(layout.screenBox.width - 48.0f) / 2.0f, layout.panelArea.y, 48.0f, 48.0f};
+    layout.smileyArea = ShrinkRec(layout.smileyBox, bevelThick);
+
+    // Bottom panel
+    layout.statusBox  = {bevelThick, layout.screenBox.height - statusHeight - bevelThick, layout.screenBox.width - bevelThick * 2.0f, statusHeight};
+    layout.statusArea = ShrinkRec(layout.statusBox, bevelThick);
+
+    const Rectangle &statusArea = layout.statusArea;
+    layout.widthBox  = {statusArea.x + 0.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
+    layout.heightBox = {statusArea.x + 1.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
+    layout.minesBox  = {statusArea.x + 2.0f * statusArea.width / 3.0f, statusArea.y, statusArea.width / 3.0f, statusArea.height};
+
+    // Board box
+    const Rectangle &screenArea = layout.screenArea;
+    layout.boardBox  = {screenArea.x, screenArea.y + layout.panelBox.height, screenArea.width, screenArea.height - layout.panelBox.height - layout.statusBox.height};
+    layout.boardArea = ShrinkRec(layout.boardBox, bevelThick);
+
+    // Grid
+    const Vector2 cellSizeV = {layout.boardArea.width / boardWidth, layout.boardArea.height / boardHeight};
+    layout.cellSize         = std::min(cellSizeV.x, cellSizeV.y);
+    layout.padding          = cellSizeV.x > cellSizeV.y ? Vector2{(cellSizeV.x - cellSizeV.y) * boardWidth / 2.0f, 0.0f} : Vector2{0.0f, (cellSizeV.y - cellSizeV.x) * boardHeight / 2.0f};
+
+    return layout;
+}
+
+Rectangle rlmsg::GetCellBox(const Layout &layout, int x, int y) {
+    return {layout.boardArea.x + layout.padding.x + layout.cellSize * x, layout.boardArea.y + layout.padding.y + layout.cellSize * y, layout.cellSize, layout.cellSize};
+}
+
+void rlmsg::GetCellAt(const Layout &layout, Vector2 point, int &x, int &y) {
+    x = std::floor((point.x - layout.boardArea.x - layout.padding.x) / layout.cellSize);
+    y = std::floor((point.y - layout.boardArea.y - layout.padding.y) / layout.cellSize);
+}
+
+bool rlmsg::UseBoardTexture(const Layout &layout) {
+    return layout.cellSize < pixelCellSize;
+}
+
+void rlmsg::UpdateBoardTexture(BoardTexture &boardTexture, const rlms::minesweeper &ms, const rlms::change_set &changes) {
+    Renderer &renderer = GetRenderer();
+
+    const int width  = ms.cfg.width;
+    const int height = ms.cfg.height;
+
+    // A new board size needs a new texture
+    if (boardTexture.texture.id == 0 || boardTexture.width != width || boardTexture.height != height) {
+        if (boardTexture.texture.id != 0) {
+            renderer.UnloadTexture(boardTexture.texture);
+        }
+
+        boardTexture.pixels.assign(width * height, BLANK);
+        const Image image    = {boardTexture.pixels.data(), width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        boardTexture.texture = renderer.LoadTextureFromImage(image);
+        boardTexture.width   = width;
+        boardTexture.height  = height;
+        boardTexture.valid   = false;
+    }
+
+    // The theme and the game state change the colors of many cells at once
+    if (!boardTexture.valid || boardTexture.dark != isDarkTheme || boardTexture.state != ms.state) {
+        for (int x = 0; x < width; x++) {
+            for (int y = 0; y < height; y++) {
+                boardTexture.pixels[y * width + x] = GetCellPixel(ms, ms.at(x, y));
+            }
+        }
+        renderer.UpdateTextureRec(boardTexture.texture, {0.0f, 0.0f, (float)width, (float)height}, boardTexture.pixels.data());
+
+        boardTexture.valid = true;
+        boardTexture.dark  = isDarkTheme;
+        boardTexture.state = ms.state;
+        return;
+    }
+
+    if (changes.cells.empty()) {
+        return;
+    }
+
+    // Update the changed texels, with the current state as a cell may have
+    // changed more than once
+    int minX = width, minY = height, maxX = 0, maxY = 0;
+    for (const auto &change : changes.cells) {
+        boardTexture.pixels[change.y * width + change.x] = GetCellPixel(ms, ms.at(change.x, change.y));
+
+        minX = std::min(minX, change.x);
+        minY = std::min(minY, change.y);
+        maxX = std::max(maxX, change.x);
+        maxY = std::max(maxY, change.y);
+    }
+
+    if (changes.cells.size() <= maxTexelUpdates) {
+        for (const auto &change : changes.cells) {
+            renderer.UpdateTextureRec(boardTexture.texture, {(float)change.x, (float)change.y, 1.0f, 1.0f}, &boardTexture.pixels[change.y * width + change.x]);
+        }
+        return;
+    }
+
+    // Many changes (a cascade), upload their bounding rectangle at once
+    const int rectWidth  = maxX - minX + 1;
+    const int rectHeight = maxY - minY + 1;
+    boardTexture.scratch.resize(rectWidth * rectHeight);
+    for (int y = 0; y < rectHeight; y++) {
+        const Color *row = &boardTexture.pixels[(minY + y) * width + minX];
+        std::copy(row, row + rectWidth, &boardTexture.scratch[y * rectWidth]);
+    }
+    renderer.UpdateTextureRec(boardTexture.texture, {(float)minX, (float)minY, (float)rectWidth, (float)rectHeight}, boardTexture.scratch.data());
+}
+
+void rlmsg::UnloadBoardTexture(BoardTexture &boardTexture) {
+    if (boardTexture.texture.id != 0) {
+        GetRenderer().UnloadTexture(boardTexture.texture);
+    }
+    boardTexture = {};
+}
+
+void rlmsg::DrawGame(const Layout &layout, const GameView &view) {
+    using namespace rlms;
+
+    const minesweeper &ms       = *view.ms;
+    const config      &cfg      = *view.cfg;
+    Renderer          &renderer = GetRenderer();
+
+    DrawBeveledRectangle(layout.screenBox, bevelThick);
+    DrawBeveledRectangleInv(layout.panelBox, bevelThick);
+
+    // Score display
+    char scoreText[16];
+    std::snprintf(scoreText, sizeof(scoreText), "%03d", ms.cells_flagged());
+    DrawLEDText(scoreText, {layout.panelArea.x, layout.panelArea.y}, 48.0f);
+
+    // Time display
+    char timerText[16];
+    std::snprintf(timerText, sizeof(timerText), "%03d", view.timer);
+    DrawLEDText(timerText, {layout.panelArea.x + layout.panelArea.width - MeasureLEDText(timerText, 48.0f).x, layout.panelArea.y}, 48.0f);
+
+    // Smiley - The personal judger
+    const Texture texture =
+        ms.state == game_state::lost
+            ? faceLost
+        : ms.state == game_state::won
+            ? faceWon
+        : view.held
+            ? faceClicking
+            : face;
+
+    if (view.smileyPressed)
+        DrawBeveledRectangleInv(layout.smileyBox, bevelThick);
+    else
+        DrawBeveledRectangle(layout.smileyBox, bevelThick);
+    DrawTextureDest(texture, layout.smileyArea);
+
+    // Editable config
+    char configText[32];
+    DrawBeveledRectangleInv(layout.statusBox, bevelThick);
+    std::snprintf(configText, sizeof(configText), "Width: %d", cfg.width);
+    DrawTextCentered(font24, configText, layout.widthBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
+    std::snprintf(configText, sizeof(configText), "Height: %d", cfg.height);
+    DrawTextCentered(font24, configText, layout.heightBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
+    std::snprintf(configText, sizeof(configText), "Mines: %d", cfg.mines);
+    DrawTextCentered(font24, configText, layout.minesBox, 24.0f, 1.0f, isDarkTheme ? textDark : textLight);
+
+    // Board
+    DrawBeveledRectangleInv(layout.boardBox, bevelThick);
+
+    // Too small for any detail, draw the board as a single quad
+    if (view.boardTexture && view.boardTexture->valid && UseBoardTexture(layout)) {
+        const Rectangle grid = {layout.boardArea.x + layout.padding.x, layout.boardArea.y + layout.padding.y, layout.cellSize * ms.cfg.width, layout.cellSize * ms.cfg.height};
+        DrawTextureDest(view.boardTexture->texture, grid);
+        return;
+    }
+
+    const bool gameOver = ms.state == game_state::won || ms.state == game_state::lost;
+
+    // Cells pressed down while held: the cell under the mouse, or its
+    // neighbors when it is revealed (speed reveal)
+    const bool mouseOnBoard  = view.mouseCellX >= 0 && view.mouseCellX < ms.cfg.width && view.mouseCellY >= 0 && view.mouseCellY < ms.cfg.height;
+    const bool mouseOnNumber = mouseOnBoard && ms.at(view.mouseCellX, view.mouseCellY).state == cell_state::revealed;
+    const bool showPressed   = !gameOver && view.held && mouseOnBoard;
+
+    for (int x = 0; x < ms.cfg.width; x++) {
+        for (int y = 0; y < ms.cfg.height; y++) {
+            const Rectangle cellBox    = GetCellBox(layout, x, y);
+            const Rectangle cellArea   = ShrinkRec(cellBox, cellBevelThick);
+            const Rectangle cellArea24 = {cellArea.x + (cellArea.width - 32.0f) / 2.0f, cellArea.y + (cellArea.height - 32.0f) / 2.0f, 32.0f, 32.0f};
+            const cell     &cell       = ms.at(x, y);
+
+            const int  dx        = std::abs(view.mouseCellX - x);
+            const int  dy        = std::abs(view.mouseCellY - y);
+            const bool colliding = dx == 0 && dy == 0;
+            const bool neighbor  = !colliding && dx <= 1 && dy <= 1 && mouseOnNumber;
+
+            if (cell.state != cell_state::revealed) {
+                if (showPressed && cell.state == cell_state::hidden && (colliding || neighbor))
+                    DrawBeveledRectangleInv(cellBox, cellBevelThick);
+                else
+                    DrawBeveledRectangle(cellBox, cellBevelThick);
+
+                if (cell.state == cell_state::flagged) {
+                    DrawTextureDest(flag, cellArea24);
+                    if (gameOver && !cell.is_mine) {
+                        DrawTextureDest(crossMark, cellArea24);
+                    }
+                }
+                if (cell.state == cell_state::qmarked) {
+                    DrawTextCentered(font32, "?", cellArea, 32.0f, 0.0f, isDarkTheme ? textDark : textLight);
+                }
+
+                if (gameOver && cell.state == cell_state::hidden && cell.is_mine) {
+                    DrawTextureDest(bomb, cellArea24);
+                }
+            } else {
+                if (cell.n_mines != 0) {
+                    const char number[2] = {char('0' + cell.n_mines), '\0'};
+                    DrawTextCentered(font32, number, cellArea, 32.0f, 0.0f, GetMineNumberColor(cell.n_mines));
+                }
+                if (cell.is_mine) {
+                    renderer.DrawRectangleRec(cellArea, incorrect);
+                    DrawTextureDest(bomb, cellArea24);
+                }
+            }
+        }
+    }
+
+    // Ripple of the reveal cascade in progress, the wavefront cells pressed down
+    for (auto [x, y] : ms.wavefront) {
+        if (ms.at(x, y).state == cell_state::hidden) {
+            DrawBeveledRectangleInv(GetCellBox(layout, x, y), cellBevelThick);
+        }
+    }
 }
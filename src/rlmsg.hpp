@@ -5,14 +5,20 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "raylib.h"
+#include "rlms.hpp"
+#include "rlmsgrender.hpp"
 
 namespace rlmsg {
 
 /// Get color from HSLA values.
 Color ColorFromHSLA(float hue, float saturation, float lightness, float alpha = 1.0f);
 
+/// Shrink a rectangle from all sides.
+Rectangle ShrinkRec(Rectangle rec, float shrink);
+
 /// Draw text centered in the bounds.
 void DrawTextCentered(Font font, const char *text, Rectangle bounds, float fontSize, float spacing, Color tint);
 
@@ -68,6 +74,12 @@ inline const Color ledBgDark  = ColorFromHSLA(0.0f, 1.0f, 0.25f);
 // Incorrect cell color
 inline const Color incorrect = ColorFromHSLA(0.0f, 1.0f, 0.5f);
 
+// Pixel-per-cell board colors, the rest use the tile and number colors
+
+inline const Color pixelFlag  = ColorFromHSLA(30.0f, 1.0f, 0.5f);
+inline const Color pixelQmark = ColorFromHSLA(60.0f, 1.0f, 0.5f);
+inline const Color pixelMine  = ColorFromHSLA(0.0f, 0.0f, 0.1f);
+
 extern bool isDarkTheme; ///< Whether the GUI is dark themed.
 
 extern Font font24; ///< Font (size 24) for all UI text (including cell numbers, led text, etc.).
@@ -101,4 +113,84 @@ void DrawLEDText(const std::string &text, Vector2 position, float fontSize);
 
 Vector2 MeasureLEDText(const std::string &text, float fontSize);
 
+// Layout sizes
+
+inline constexpr float bevelThick     = 5.0f;
+inline constexpr float cellBevelThick = 2.0f;
+inline constexpr float panelHeight    = 63.0f - bevelThick;
+inline constexpr float statusHeight   = 63.0f - bevelThick;
+
+/// Positions of all the GUI elements for a screen and board size.
+struct Layout {
+    Rectangle screenBox;
+    Rectangle screenArea;
+    Rectangle panelBox;
+    Rectangle panelArea;
+    Rectangle smileyBox;
+    Rectangle smileyArea;
+    Rectangle statusBox;
+    Rectangle statusArea;
+    Rectangle widthBox;
+    Rectangle heightBox;
+    Rectangle minesBox;
+    Rectangle boardBox;
+    Rectangle boardArea;
+    Vector2   padding;  ///< Board padding to keep the cells square.
+    float     cellSize; ///< Cell side length.
+};
+
+/// Compute the layout of the screen for the board size.
+Layout ComputeLayout(Rectangle screen, int boardWidth, int boardHeight);
+
+/// Get the cell box of the cell in the layout.
+Rectangle GetCellBox(const Layout &layout, int x, int y);
+
+/// Get the cell under the point in the layout, may be outside the board.
+void GetCellAt(const Layout &layout, Vector2 point, int &x, int &y);
+
+/// Cell size (in pixels) below which the board is drawn as a single texture
+/// with a texel per cell, instead of a tile per cell.
+inline constexpr float pixelCellSize = 8.0f;
+
+/// Board drawn as a texture with a texel per cell, for boards too large for
+/// the cells to show any detail.
+/// @note The texels are updated from the change sets, only a change of the
+///       board size, theme or game state rebuilds the whole texture.
+struct BoardTexture {
+    Texture            texture = {};    ///< The texture, texel (x, y) is cell (x, y).
+    std::vector<Color> pixels;          ///< Texels of the texture.
+    std::vector<Color> scratch;         ///< Packed texels of an updated rectangle.
+    int                width   = 0;     ///< Board width the texture was built for.
+    int                height  = 0;     ///< Board height the texture was built for.
+    bool               dark    = false; ///< Theme the texture was built for.
+    bool               valid   = false; ///< Whether the texels are up to date.
+
+    rlms::game_state state = rlms::game_state::first_click; ///< Game state the texture was built for.
+};
+
+/// Whether the board is drawn as a texture in the layout.
+bool UseBoardTexture(const Layout &layout);
+
+/// Bring the board texture up to date with the board, given the changes since
+/// the last update.
+void UpdateBoardTexture(BoardTexture &boardTexture, const rlms::minesweeper &ms, const rlms::change_set &changes);
+
+/// Unload the board texture.
+void UnloadBoardTexture(BoardTexture &boardTexture);
+
+/// Everything a frame shows, besides the theme and resources.
+struct GameView {
+    const rlms::minesweeper *ms;            ///< The board.
+    const rlms::config      *cfg;           ///< The editable config shown in the status panel.
+    int                      timer;         ///< Timer seconds.
+    int                      mouseCellX;    ///< Cell under the mouse, may be outside the board.
+    int                      mouseCellY;    ///< Cell under the mouse, may be outside the board.
+    bool                     held;          ///< Whether a mouse button is held.
+    bool                     smileyPressed; ///< Whether the smiley is held down.
+    const BoardTexture      *boardTexture;  ///< The board texture, drawn instead of the tiles when used.
+};
+
+/// Draw the whole game frame (panels, HUD and board) through the renderer.
+void DrawGame(const Layout &layout, const GameView &view);
+
 } // namespace rlmsg
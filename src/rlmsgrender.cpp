@@ -0,0 +1,178 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <cstdio>
+#include <cstring>
+
+#include "rlmsgrender.hpp"
+
+namespace {
+
+rlmsg::RaylibRenderer raylibRenderer;
+rlmsg::Renderer      *renderer = &raylibRenderer;
+
+} // namespace
+
+void rlmsg::RaylibRenderer::DrawRectangleRec(Rectangle rec, Color color) {
+    ::DrawRectangleRec(rec, color);
+}
+
+void rlmsg::RaylibRenderer::DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    ::DrawTriangle(v1, v2, v3, color);
+}
+
+void rlmsg::RaylibRenderer::DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint) {
+    ::DrawTextEx(font, text, position, fontSize, spacing, tint);
+}
+
+void rlmsg::RaylibRenderer::DrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) {
+    ::DrawTexturePro(texture, source, dest, origin, rotation, tint);
+}
+
+Vector2 rlmsg::RaylibRenderer::MeasureTextEx(Font font, const char *text, float fontSize, float spacing) {
+    return ::MeasureTextEx(font, text, fontSize, spacing);
+}
+
+Texture rlmsg::RaylibRenderer::LoadTextureFromImage(Image image) {
+    return ::LoadTextureFromImage(image);
+}
+
+void rlmsg::RaylibRenderer::UnloadTexture(Texture texture) {
+    ::UnloadTexture(texture);
+}
+
+void rlmsg::RaylibRenderer::UpdateTextureRec(Texture texture, Rectangle rec, const void *pixels) {
+    ::UpdateTextureRec(texture, rec, pixels);
+}
+
+void rlmsg::RecordingRenderer::DrawRectangleRec(Rectangle rec, Color color) {
+    DrawCommand command = {};
+    command.type        = DrawCommandType::Rectangle;
+    command.color       = color;
+    command.rec         = rec;
+    commands.push_back(command);
+}
+
+void rlmsg::RecordingRenderer::DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
+    DrawCommand command = {};
+    command.type        = DrawCommandType::Triangle;
+    command.color       = color;
+    command.v[0]        = v1;
+    command.v[1]        = v2;
+    command.v[2]        = v3;
+    commands.push_back(command);
+}
+
+void rlmsg::RecordingRenderer::DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint) {
+    DrawCommand command = {};
+    command.type        = DrawCommandType::Text;
+    command.color       = tint;
+    command.v[0]        = position;
+    command.fontSize    = fontSize;
+    command.spacing     = spacing;
+    command.textureId   = font.texture.id;
+    command.textOffset  = textBuffer.size();
+    command.textLength  = std::strlen(text);
+    textBuffer.append(text, command.textLength);
+    commands.push_back(command);
+}
+
+void rlmsg::RecordingRenderer::DrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2, float, Color tint) {
+    DrawCommand command = {};
+    command.type        = DrawCommandType::Texture;
+    command.color       = tint;
+    command.rec         = dest;
+    command.source      = source;
+    command.textureId   = texture.id;
+    commands.push_back(command);
+}
+
+Vector2 rlmsg::RecordingRenderer::MeasureTextEx(Font, const char *text, float fontSize, float spacing) {
+    const std::size_t length = std::strlen(text);
+    if (length == 0) {
+        return {0.0f, fontSize};
+    }
+    return {length * fontSize / 2.0f + (length - 1) * spacing, fontSize};
+}
+
+Texture rlmsg::RecordingRenderer::LoadTextureFromImage(Image image) {
+    return {nextTextureId++, image.width, image.height, 1, image.format};
+}
+
+void rlmsg::RecordingRenderer::UnloadTexture(Texture) {
+    // Nothing is loaded
+}
+
+void rlmsg::RecordingRenderer::UpdateTextureRec(Texture texture, Rectangle rec, const void *) {
+    DrawCommand command = {};
+    command.type        = DrawCommandType::TextureUpdate;
+    command.rec         = rec;
+    command.textureId   = texture.id;
+    commands.push_back(command);
+}
+
+void rlmsg::RecordingRenderer::Clear() {
+    commands.clear();
+    textBuffer.clear();
+}
+
+std::size_t rlmsg::RecordingRenderer::Count(DrawCommandType type) const {
+    std::size_t count = 0;
+    for (const auto &command : commands) {
+        if (command.type == type) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::string rlmsg::RecordingRenderer::Serialize() const {
+    std::string out;
+    char        line[256];
+
+    for (const auto &command : commands) {
+        const Color c = command.color;
+
+        switch (command.type) {
+        case DrawCommandType::Rectangle:
+            std::snprintf(line, sizeof(line), "rect %g %g %g %g #%02x%02x%02x%02x\n",
+                          command.rec.x, command.rec.y, command.rec.width, command.rec.height, c.r, c.g, c.b, c.a);
+            out += line;
+            break;
+        case DrawCommandType::Triangle:
+            std::snprintf(line, sizeof(line), "tri %g %g %g %g %g %g #%02x%02x%02x%02x\n",
+                          command.v[0].x, command.v[0].y, command.v[1].x, command.v[1].y, command.v[2].x, command.v[2].y, c.r, c.g, c.b, c.a);
+            out += line;
+            break;
+        case DrawCommandType::Text:
+            std::snprintf(line, sizeof(line), "text %u %g %g %g %g #%02x%02x%02x%02x ",
+                          command.textureId, command.v[0].x, command.v[0].y, command.fontSize, command.spacing, c.r, c.g, c.b, c.a);
+            out += line;
+            out.append(textBuffer, command.textOffset, command.textLength);
+            out += '\n';
+            break;
+        case DrawCommandType::Texture:
+            std::snprintf(line, sizeof(line), "tex %u %g %g %g %g -> %g %g %g %g #%02x%02x%02x%02x\n",
+                          command.textureId, command.source.x, command.source.y, command.source.width, command.source.height,
+                          command.rec.x, command.rec.y, command.rec.width, command.rec.height, c.r, c.g, c.b, c.a);
+            out += line;
+            break;
+        case DrawCommandType::TextureUpdate:
+            std::snprintf(line, sizeof(line), "update %u %g %g %g %g\n",
+                          command.textureId, command.rec.x, command.rec.y, command.rec.width, command.rec.height);
+            out += line;
+            break;
+        }
+    }
+
+    return out;
+}
+
+rlmsg::Renderer &rlmsg::GetRenderer() {
+    return *renderer;
+}
+
+void rlmsg::SetRenderer(Renderer &renderer) {
+    ::renderer = &renderer;
+}
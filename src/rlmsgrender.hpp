@@ -0,0 +1,106 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+
+namespace rlmsg {
+
+/// Thin drawing interface that all the GUI drawing goes through.
+struct Renderer {
+    virtual ~Renderer() = default;
+
+    virtual void DrawRectangleRec(Rectangle rec, Color color)                                                                  = 0;
+    virtual void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color)                                                 = 0;
+    virtual void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint)          = 0;
+    virtual void DrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) = 0;
+
+    virtual Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing) = 0;
+
+    virtual Texture LoadTextureFromImage(Image image)                                    = 0;
+    virtual void    UnloadTexture(Texture texture)                                       = 0;
+    virtual void    UpdateTextureRec(Texture texture, Rectangle rec, const void *pixels) = 0;
+};
+
+/// Renderer that draws with raylib.
+struct RaylibRenderer : Renderer {
+    void DrawRectangleRec(Rectangle rec, Color color) override;
+    void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) override;
+    void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint) override;
+    void DrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) override;
+
+    Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing) override;
+
+    Texture LoadTextureFromImage(Image image) override;
+    void    UnloadTexture(Texture texture) override;
+    void    UpdateTextureRec(Texture texture, Rectangle rec, const void *pixels) override;
+};
+
+/// Kind of recorded draw command.
+enum class DrawCommandType {
+    Rectangle,
+    Triangle,
+    Text,
+    Texture,
+    TextureUpdate ///< Texels uploaded to a texture, not a draw.
+};
+
+/// Recorded draw command.
+struct DrawCommand {
+    DrawCommandType type;
+    Color           color;
+    Rectangle       rec;         ///< Rectangle, the texture destination, or the updated texels.
+    Rectangle       source;      ///< Texture source.
+    Vector2         v[3];        ///< Triangle vertices, or the text position.
+    float           fontSize;    ///< Text font size.
+    float           spacing;     ///< Text spacing.
+    unsigned int    textureId;   ///< Texture (or font texture) id.
+    std::size_t     textOffset;  ///< Text offset in the text buffer.
+    std::size_t     textLength;  ///< Text length.
+};
+
+/// Renderer that records the draw commands in memory instead of drawing, to
+/// measure and compare frames without a GPU.
+/// @note Text is measured with fixed metrics (half the font size per glyph),
+///       as fonts can not be loaded without a window. Loaded textures only get
+///       an id and a size.
+struct RecordingRenderer : Renderer {
+    std::vector<DrawCommand> commands;             ///< Recorded commands, in draw order.
+    std::string              textBuffer;           ///< Text of all the text commands.
+    unsigned int             nextTextureId = 1000; ///< Id of the next loaded texture.
+
+    void DrawRectangleRec(Rectangle rec, Color color) override;
+    void DrawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) override;
+    void DrawTextEx(Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint) override;
+    void DrawTexturePro(Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint) override;
+
+    Vector2 MeasureTextEx(Font font, const char *text, float fontSize, float spacing) override;
+
+    Texture LoadTextureFromImage(Image image) override;
+    void    UnloadTexture(Texture texture) override;
+    void    UpdateTextureRec(Texture texture, Rectangle rec, const void *pixels) override;
+
+    /// Clear the recorded commands, keeping the capacity.
+    void Clear();
+
+    /// Number of recorded commands of the type.
+    std::size_t Count(DrawCommandType type) const;
+
+    /// Serialize the recorded commands as text, one command per line.
+    std::string Serialize() const;
+};
+
+/// Get the renderer used by all the drawing functions. Defaults to raylib.
+Renderer &GetRenderer();
+
+/// Set the renderer used by all the drawing functions.
+/// @note The renderer must outlive its use.
+void SetRenderer(Renderer &renderer);
+
+} // namespace rlmsg
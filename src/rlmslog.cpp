@@ -0,0 +1,299 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "rlmslog.hpp"
+
+namespace {
+
+constexpr char         log_magic[] = {'R', 'L', 'M', 'S', 'L', 'O', 'G'};
+/// Version 1 has no difficulty filter, version 2 counted the deduction rounds
+/// of the filter differently.
+constexpr std::uint8_t log_version = 3;
+
+/// Record tags.
+enum tag : std::uint8_t {
+    tag_game      = 0,
+    tag_primary   = 1,
+    tag_secondary = 2,
+    tag_end       = 3
+};
+
+void put_varint(std::string &out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+
+void put_u64(std::string &out, std::uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out += char(value >> (i * 8));
+    }
+}
+
+/// Reads the fields of the records, failing at the end of the data.
+struct reader {
+    const std::string &data;
+    std::size_t        pos = 0;
+    bool               ok  = true;
+
+    bool at_end() const { return pos >= data.size(); }
+
+    std::uint8_t byte() {
+        if (at_end()) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t b = byte();
+            value |= std::uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::uint64_t u64() {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; i++) {
+            value |= std::uint64_t(byte()) << (i * 8);
+        }
+        return value;
+    }
+};
+
+} // namespace
+
+std::uint64_t rlms::board_hash(const minesweeper &ms) {
+    // FNV-1a over the cells
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (int x = 0; x < ms.cfg.width; x++) {
+        for (int y = 0; y < ms.cfg.height; y++) {
+            const cell &c = ms.at(x, y);
+            hash ^= std::uint8_t(int(c.state) | (c.is_mine << 4));
+            hash *= 0x100000001b3;
+        }
+    }
+    return hash;
+}
+
+rlms::action_recorder::~action_recorder() {
+    if (file) {
+        std::fwrite(buffer.data(), 1, buffer.size(), file);
+        std::fclose(file);
+    }
+}
+
+bool rlms::action_recorder::open(const std::string &path) {
+    if (file) {
+        std::fclose(file);
+    }
+
+    file = std::fopen(path.c_str(), "a+b");
+    if (!file) {
+        return false;
+    }
+
+    buffer.clear();
+    in_game = false;
+
+    // A new file starts with the header, an existing one must be of this
+    // version to append to
+    std::fseek(file, 0, SEEK_END);
+    if (std::ftell(file) == 0) {
+        buffer.append(log_magic, sizeof(log_magic));
+        buffer += char(log_version);
+        return true;
+    }
+
+    char header[sizeof(log_magic) + 1] = {};
+    std::fseek(file, 0, SEEK_SET);
+    if (std::fread(header, 1, sizeof(header), file) != sizeof(header) || std::memcmp(header, log_magic, sizeof(log_magic)) != 0 || header[sizeof(log_magic)] != log_version) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool rlms::action_recorder::is_open() const {
+    return file;
+}
+
+void rlms::action_recorder::begin_game(const config &cfg) {
+    // The game can be configured out of range, such games are not recorded
+    in_game = false;
+    if (!file || !cfg.validate()) {
+        return;
+    }
+
+    buffer += char(tag_game);
+    put_varint(buffer, cfg.width);
+    put_varint(buffer, cfg.height);
+    put_varint(buffer, cfg.mines);
+    put_varint(buffer, cfg.attempts);
+    put_u64(buffer, cfg.seed);
+    buffer += char(cfg.engine);
+    buffer += char(cfg.generator);
+    put_varint(buffer, std::max(cfg.filter.min_bbbv, 0));
+    put_varint(buffer, std::max(cfg.filter.max_bbbv, 0));
+    put_varint(buffer, std::max(cfg.filter.min_rounds, 0));
+    put_varint(buffer, std::max(cfg.filter.max_rounds, 0));
+
+    last_time = 0;
+    in_game   = true;
+}
+
+void rlms::action_recorder::record(std::uint32_t time_ms, const action &a) {
+    if (!file || !in_game) {
+        return;
+    }
+
+    buffer += char(a.type == action_type::primary ? tag_primary : tag_secondary);
+    put_varint(buffer, time_ms >= last_time ? time_ms - last_time : 0);
+    put_varint(buffer, a.x);
+    put_varint(buffer, a.y);
+    last_time = std::max(last_time, time_ms);
+}
+
+void rlms::action_recorder::end_game(const minesweeper &ms) {
+    if (!file || !in_game) {
+        return;
+    }
+
+    buffer += char(tag_end);
+    buffer += char(ms.state);
+    put_u64(buffer, board_hash(ms));
+    in_game = false;
+
+    std::fwrite(buffer.data(), 1, buffer.size(), file);
+    std::fflush(file);
+    buffer.clear();
+}
+
+bool rlms::read_action_log(const std::string &path, std::vector<game_log> &games) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    std::string data;
+    char        chunk[65536];
+    std::size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        data.append(chunk, read);
+    }
+    std::fclose(file);
+
+    if (data.size() < sizeof(log_magic) + 1 || std::memcmp(data.data(), log_magic, sizeof(log_magic)) != 0) {
+        return false;
+    }
+
+    const std::uint8_t version = data[sizeof(log_magic)];
+    if (version < 1 || version > log_version) {
+        return false;
+    }
+
+    reader        in   = {data, sizeof(log_magic) + 1};
+    game_log     *game = nullptr;
+    bool          skip = false; ///< Whether the records belong to a skipped game.
+    std::uint32_t time = 0;
+
+    while (!in.at_end()) {
+        const std::uint8_t t = in.byte();
+
+        if (t == tag_game) {
+            game_log log;
+            log.cfg.width     = in.varint();
+            log.cfg.height    = in.varint();
+            log.cfg.mines     = in.varint();
+            log.cfg.attempts  = in.varint();
+            log.cfg.seed      = in.u64();
+
+            const std::uint8_t engine    = in.byte();
+            const std::uint8_t generator = in.byte();
+            if (version >= 2) {
+                log.cfg.filter.min_bbbv   = in.varint();
+                log.cfg.filter.max_bbbv   = in.varint();
+                log.cfg.filter.min_rounds = in.varint();
+                log.cfg.filter.max_rounds = in.varint();
+            }
+            if (!in.ok || engine > std::uint8_t(rng_engine::mt19937) || generator > std::uint8_t(generator_algorithm::constructive)) {
+                return false;
+            }
+            log.cfg.engine    = (rng_engine)engine;
+            log.cfg.generator = (generator_algorithm)generator;
+
+            // Older recorders logged games configured out of range, skip them
+            // and their records, as well as the games that limited the rounds
+            // counted differently
+            game = nullptr;
+            skip = !log.cfg.validate() || (version == 2 && log.cfg.filter.checks_rounds());
+            time = 0;
+            if (!skip) {
+                games.push_back(std::move(log));
+                game = &games.back();
+            }
+        } else if ((t == tag_primary || t == tag_secondary) && ((game && !game->ended) || skip)) {
+            time += in.varint();
+            const int x = in.varint();
+            const int y = in.varint();
+            if (!in.ok) {
+                return false;
+            }
+
+            if (game) {
+                game->actions.push_back({time, {t == tag_primary ? action_type::primary : action_type::secondary, x, y}});
+            }
+        } else if (t == tag_end && ((game && !game->ended) || skip)) {
+            const std::uint8_t  state = in.byte();
+            const std::uint64_t hash  = in.u64();
+            if (!in.ok || state > std::uint8_t(game_state::lost)) {
+                return false;
+            }
+
+            skip = false;
+            if (game) {
+                game->state = (game_state)state;
+                game->hash  = hash;
+                game->ended = true;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool rlms::replay(minesweeper &ms, const game_log &game, latency_histogram *click_latency) {
+    ms.cfg            = game.cfg;
+    ms.cascade_budget = 0;
+    ms.reset();
+
+    for (const auto &recorded : game.actions) {
+        if (!click_latency) {
+            apply(ms, recorded.act);
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        apply(ms, recorded.act);
+        click_latency->add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return !game.ended || (ms.state == game.state && board_hash(ms) == game.hash);
+}
@@ -0,0 +1,95 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "rlms.hpp"
+#include "rlmssim.hpp"
+
+namespace rlms {
+
+/// Recorded player action.
+struct timed_action {
+    std::uint32_t time_ms; ///< Milliseconds since the start of the game.
+    action        act;     ///< The action.
+};
+
+/// Recorded game. The config (with the seed) and the actions fully determine
+/// the game.
+struct game_log {
+    config                    cfg;                             ///< Board configuration of the game.
+    std::vector<timed_action> actions;                         ///< Actions, in order.
+    bool                      ended = false;                   ///< Whether the final state was recorded.
+    game_state                state = game_state::first_click; ///< Final game state.
+    std::uint64_t             hash  = 0;                       ///< Final board_hash.
+};
+
+/// Hash of the mines and the cell states of the board, to compare final states.
+std::uint64_t board_hash(const minesweeper &ms);
+
+/// Appends the actions of the games played to an action log file.
+/// @note The file starts with "RLMSLOG" and a version byte, followed by the
+///       records, each a tag byte and its fields. Integers are LEB128
+///       varints, except for the seed and the hash, which are 8 bytes little
+///       endian.
+///       - 0 game:      width, height, mines, attempts, seed, engine byte,
+///                      generator byte, difficulty filter min and max 3BV,
+///                      min and max rounds (not in version 1).
+///       - 1 primary,
+///         2 secondary: milliseconds since the previous action (or the
+///                      start of the game), x, y.
+///       - 3 end:       game state byte, hash.
+///       A click is 4 to 6 bytes. The records are buffered and written at the
+///       end of every game.
+class action_recorder {
+public:
+    action_recorder() = default;
+    ~action_recorder();
+
+    action_recorder(const action_recorder &)            = delete;
+    action_recorder &operator=(const action_recorder &) = delete;
+
+    /// Open the log file to append to. Returns whether it could be opened, and
+    /// is a log of the current version if it is not empty.
+    bool open(const std::string &path);
+
+    /// Whether a log file is open. Nothing is recorded otherwise.
+    bool is_open() const;
+
+    /// Start recording a new game with the board configuration.
+    void begin_game(const config &cfg);
+
+    /// Record an action of the game.
+    void record(std::uint32_t time_ms, const action &a);
+
+    /// Record the final state of the game and write the game to the file.
+    void end_game(const minesweeper &ms);
+
+private:
+    std::FILE    *file      = nullptr;
+    std::string   buffer;        ///< Records not written yet.
+    std::uint32_t last_time = 0; ///< Time of the previous action.
+    bool          in_game   = false;
+};
+
+/// Read all the games of the log file. The last game may have no end if the
+/// recording was cut short. Games that can not be reproduced, with a
+/// configuration that does not validate or deduction rounds limited in a
+/// version 2 log, are skipped. Returns false if the file can not be read or is
+/// malformed, in which case the games read before the error are kept.
+bool read_action_log(const std::string &path, std::vector<game_log> &games);
+
+/// Replay the game on the board, as fast as possible. Returns whether the
+/// final state matches the recorded one (always true for games without end).
+/// The time of every click is added to the histogram, if given.
+/// @note Reveal cascades are completed at once, as the clicks made during a
+///       cascade are applied once it ends anyway.
+bool replay(minesweeper &ms, const game_log &game, latency_histogram *click_latency = nullptr);
+
+}; // namespace rlms
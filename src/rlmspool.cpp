@@ -0,0 +1,137 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+
+#include "rlmspool.hpp"
+
+rlms::thread_pool::thread_pool(int threads) {
+    if (threads < 1) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < threads; i++) {
+        queues.push_back(std::make_unique<worker_queue>());
+    }
+
+    for (int i = 0; i < threads; i++) {
+        this->threads.emplace_back(&thread_pool::worker_loop, this, i);
+    }
+}
+
+rlms::thread_pool::~thread_pool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+int rlms::thread_pool::size() const {
+    return threads.size();
+}
+
+void rlms::thread_pool::run(int tasks, const task &fn) {
+    if (tasks < 1) {
+        return;
+    }
+
+    std::unique_lock lock(mutex);
+
+    // Hand out contiguous blocks of tasks, so neighboring tasks stay on the
+    // same worker until somebody steals them
+    const int workers = size();
+    for (int w = 0; w < workers; w++) {
+        auto &queue = *queues[w];
+
+        std::lock_guard queue_lock(queue.mutex);
+        queue.tasks.clear();
+        queue.head = 0;
+
+        const int begin = (long long)tasks * w / workers;
+        const int end   = (long long)tasks * (w + 1) / workers;
+
+        // Pushed in reverse, so the owner pops tasks in ascending order
+        for (int t = end - 1; t >= begin; t--) {
+            queue.tasks.push_back(t);
+        }
+    }
+
+    remaining = tasks;
+    job       = &fn;
+    generation++;
+    wake.notify_all();
+
+    // Also wait for the workers to leave the job, so none of them touches the
+    // task function after it goes out of scope
+    done.wait(lock, [&] { return remaining == 0 && busy == 0; });
+    job = nullptr;
+}
+
+bool rlms::thread_pool::pop(int worker, int &task) {
+    auto &queue = *queues[worker];
+
+    std::lock_guard lock(queue.mutex);
+    if (queue.head == queue.tasks.size()) {
+        return false;
+    }
+
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool rlms::thread_pool::steal(int worker, int &task) {
+    const int workers = size();
+    for (int i = 1; i < workers; i++) {
+        auto &queue = *queues[(worker + i) % workers];
+
+        std::lock_guard lock(queue.mutex);
+        if (queue.head == queue.tasks.size()) {
+            continue;
+        }
+
+        task = queue.tasks[queue.head++];
+        return true;
+    }
+
+    return false;
+}
+
+void rlms::thread_pool::worker_loop(int worker) {
+    std::uint64_t seen = 0;
+
+    while (true) {
+        const task *fn = nullptr;
+
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+
+            if (stopping) {
+                return;
+            }
+
+            seen = generation;
+            fn   = job;
+            busy++;
+        }
+
+        int task = 0;
+        while (fn && (pop(worker, task) || steal(worker, task))) {
+            (*fn)(task, worker);
+            remaining--;
+        }
+
+        {
+            std::lock_guard lock(mutex);
+            busy--;
+        }
+        done.notify_all();
+    }
+}
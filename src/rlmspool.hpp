@@ -0,0 +1,75 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rlms {
+
+/// Work-stealing thread pool.
+/// @note Each worker owns a queue of task indices. A worker pops from the back
+///       of its own queue, and steals from the front of other workers' queues
+///       when its own queue runs dry. Queues keep their capacity between runs,
+///       so dispatching a job does not allocate in steady-state.
+class thread_pool {
+public:
+    /// Task function, called with the task index and the worker index.
+    using task = std::function<void(int task, int worker)>;
+
+    /// Create the pool with given number of worker threads. Use 0 to use the
+    /// hardware concurrency.
+    explicit thread_pool(int threads = 0);
+
+    ~thread_pool();
+
+    thread_pool(const thread_pool &)            = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    /// Number of worker threads.
+    int size() const;
+
+    /// Run tasks [0, tasks) on the workers and wait for all of them to
+    /// complete.
+    void run(int tasks, const task &fn);
+
+private:
+    /// Task queue of a single worker.
+    struct worker_queue {
+        std::mutex       mutex;
+        std::vector<int> tasks;
+        std::size_t      head = 0; ///< Index of the front (steal end).
+    };
+
+    /// Pop a task from the back of the worker's own queue.
+    bool pop(int worker, int &task);
+
+    /// Steal a task from the front of another worker's queue.
+    bool steal(int worker, int &task);
+
+    void worker_loop(int worker);
+
+    std::vector<std::thread>                   threads;
+    std::vector<std::unique_ptr<worker_queue>> queues;
+
+    std::mutex              mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const task   *job        = nullptr;
+    std::uint64_t generation = 0;
+    int           busy       = 0;
+    bool          stopping   = false;
+
+    std::atomic<int> remaining = 0;
+};
+
+}; // namespace rlms
@@ -0,0 +1,162 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+namespace rlms {
+
+/// SplitMix64 mixing function. Good for turning structured input (seeds,
+/// counters) into well distributed 64-bit values.
+constexpr std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x  = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x  = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/// Derive an independent 64-bit seed for the stream from the seed.
+constexpr std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream) {
+    return splitmix64(seed ^ splitmix64(stream + 0x632BE59BD9B4E019ull));
+}
+
+/// Philox4x32-10 counter-based engine.
+/// @note The output is a pure function of (seed, stream, position), so any
+///       stream can be created and skipped ahead in constant time.
+class philox4x32 {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    philox4x32() : philox4x32(0) {}
+
+    explicit philox4x32(std::uint64_t seed, std::uint64_t stream = 0) {
+        this->seed(seed, stream);
+    }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0) {
+        key     = {std::uint32_t(seed), std::uint32_t(seed >> 32)};
+        counter = {0, 0, std::uint32_t(stream), std::uint32_t(stream >> 32)};
+        index   = 2;
+    }
+
+    result_type operator()() {
+        if (index == 2) {
+            generate();
+            index = 0;
+        }
+
+        const result_type result = (result_type(block[index * 2 + 1]) << 32) | block[index * 2];
+        index++;
+        return result;
+    }
+
+    /// Skip the next n outputs in constant time.
+    void discard(std::uint64_t n) {
+        std::uint64_t position = block_index() * 2 - (2 - index) + n;
+        set_block_index(position / 2);
+        index = 2;
+
+        if (position % 2 != 0) {
+            generate();
+            index = 1;
+        }
+    }
+
+private:
+    std::uint64_t block_index() const {
+        return (std::uint64_t(counter[1]) << 32) | counter[0];
+    }
+
+    void set_block_index(std::uint64_t block) {
+        counter[0] = std::uint32_t(block);
+        counter[1] = std::uint32_t(block >> 32);
+    }
+
+    /// Encrypt the counter into the next block of output and bump the counter.
+    void generate() {
+        std::array<std::uint32_t, 4> c = counter;
+        std::array<std::uint32_t, 2> k = key;
+
+        for (int round = 0; round < 10; round++) {
+            const std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c[0];
+            const std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+
+            c = {
+                std::uint32_t(p1 >> 32) ^ c[1] ^ k[0],
+                std::uint32_t(p1),
+                std::uint32_t(p0 >> 32) ^ c[3] ^ k[1],
+                std::uint32_t(p0),
+            };
+
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+
+        block = c;
+        set_block_index(block_index() + 1);
+    }
+
+    std::array<std::uint32_t, 2> key     = {};
+    std::array<std::uint32_t, 4> counter = {}; ///< [0, 1] is the block index, [2, 3] is the stream.
+    std::array<std::uint32_t, 4> block   = {};
+    int                          index   = 2; ///< Next 64-bit output in block, 2 if used up.
+};
+
+/// SplitMix64 engine. Smaller and faster than Philox, with the same constant
+/// time stream creation and skipping, but weaker statistically.
+class splitmix {
+public:
+    using result_type = std::uint64_t;
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    splitmix() : splitmix(0) {}
+
+    explicit splitmix(std::uint64_t seed, std::uint64_t stream = 0) {
+        this->seed(seed, stream);
+    }
+
+    void seed(std::uint64_t seed, std::uint64_t stream = 0) {
+        state = derive_seed(seed, stream);
+    }
+
+    result_type operator()() {
+        const std::uint64_t x = state;
+        state += 0x9E3779B97F4A7C15ull;
+        return splitmix64(x);
+    }
+
+    /// Skip the next n outputs in constant time.
+    void discard(std::uint64_t n) {
+        state += n * 0x9E3779B97F4A7C15ull;
+    }
+
+private:
+    std::uint64_t state = 0;
+};
+
+/// Create the engine for the stream of the seed. Engines without native
+/// stream support are seeded from both through a seed sequence.
+template <typename Engine>
+Engine make_stream(std::uint64_t seed, std::uint64_t stream) {
+    if constexpr (std::is_constructible_v<Engine, std::uint64_t, std::uint64_t>) {
+        return Engine(seed, stream);
+    } else {
+        std::seed_seq seq = {
+            std::uint32_t(seed), std::uint32_t(seed >> 32),
+            std::uint32_t(stream), std::uint32_t(stream >> 32)};
+        return Engine(seq);
+    }
+}
+
+}; // namespace rlms
@@ -0,0 +1,229 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+#include "rlmssim.hpp"
+
+namespace {
+
+/// Stream id of the player's own randomness, distinct from the generation
+/// attempt streams.
+constexpr std::uint64_t player_stream = ~std::uint64_t(0);
+
+std::uint64_t elapsed_ns(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
+void rlms::apply(minesweeper &ms, const action &a) {
+    switch (a.type) {
+    case action_type::primary: ms.primary_click(a.x, a.y); break;
+    case action_type::secondary: ms.secondary_click(a.x, a.y); break;
+    }
+}
+
+void rlms::deduction_player::begin(const minesweeper &ms) {
+    gen.seed(ms.cfg.seed, player_stream);
+    cursor = 0;
+}
+
+rlms::action rlms::deduction_player::next(const minesweeper &ms) {
+    const int width  = ms.cfg.width;
+    const int height = ms.cfg.height;
+    const int size   = width * height;
+
+    if (ms.state == game_state::first_click) {
+        return {action_type::primary, width / 2, height / 2};
+    }
+
+    // Look for a forced move among the numbers next to the frontier, resuming
+    // from the last one found since the next forced move is usually nearby
+    const int n_frontier = ms.frontier.size();
+    for (int i = 0; i < n_frontier; i++) {
+        const int pos = (cursor + i) % n_frontier;
+        const int fx  = ms.frontier[pos] / height;
+        const int fy  = ms.frontier[pos] % height;
+
+        for (auto [x, y] : ms.neighbors(fx, fy)) {
+            const cell &c = ms.at(x, y);
+            if (c.state != cell_state::revealed || c.n_mines == 0 || c.n_hidden == 0) {
+                continue;
+            }
+
+            // All mines are flagged, speed reveal the rest
+            if (c.n_marked == c.n_mines) {
+                cursor = pos;
+                return {action_type::primary, x, y};
+            }
+
+            // All hidden cells are mines, speed flag them
+            if (c.n_marked + c.n_hidden == c.n_mines) {
+                cursor = pos;
+                return {action_type::secondary, x, y};
+            }
+        }
+    }
+
+    // Stuck, guess a random hidden cell
+    const int start = std::uniform_int_distribution<int>(0, size - 1)(gen);
+    for (int i = 0; i < size; i++) {
+        const int index = (start + i) % size;
+        const int x     = index / height;
+        const int y     = index % height;
+
+        if (ms.at(x, y).state == cell_state::hidden) {
+            return {action_type::primary, x, y};
+        }
+    }
+
+    return {action_type::primary, 0, 0};
+}
+
+void rlms::latency_histogram::add(std::uint64_t ns) {
+    const int bucket = std::min<int>(std::bit_width(ns | 1) - 1, n_buckets - 1);
+    buckets[bucket]++;
+    count++;
+    max = std::max(max, ns);
+}
+
+void rlms::latency_histogram::merge(const latency_histogram &other) {
+    for (int i = 0; i < n_buckets; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    max    = std::max(max, other.max);
+}
+
+std::uint64_t rlms::latency_histogram::percentile(double p) const {
+    const std::uint64_t target = std::max<std::uint64_t>(1, p * count);
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < n_buckets; i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return std::min(max, (std::uint64_t(2) << i) - 1);
+        }
+    }
+
+    return max;
+}
+
+void rlms::sim_report::merge(const sim_report &other) {
+    games      += other.games;
+    wins       += other.wins;
+    losses     += other.losses;
+    aborted    += other.aborted;
+    unsolvable += other.unsolvable;
+    clicks     += other.clicks;
+
+    scratch_allocations  += other.scratch_allocations;
+    upstream_allocations += other.upstream_allocations;
+
+    bbbv += other.bbbv;
+    generation.merge(other.generation);
+
+    game_latency.merge(other.game_latency);
+    click_latency.merge(other.click_latency);
+}
+
+double rlms::sim_report::games_per_second() const {
+    return seconds > 0 ? games / seconds : 0;
+}
+
+double rlms::sim_report::win_rate() const {
+    return games > 0 ? (double)wins / games : 0;
+}
+
+double rlms::sim_report::clicks_per_game() const {
+    return games > 0 ? (double)clicks / games : 0;
+}
+
+double rlms::sim_report::bbbv_per_game() const {
+    return games > 0 ? (double)bbbv / games : 0;
+}
+
+rlms::simulator::simulator(thread_pool &pool, player_factory factory)
+    : pool(pool), factory(std::move(factory)) {}
+
+rlms::sim_report rlms::simulator::run(const sim_options &options) {
+    if (contexts.size() != std::size_t(pool.size())) {
+        contexts = std::vector<worker_context>(pool.size());
+    }
+
+    for (auto &ctx : contexts) {
+        if (!ctx.policy) {
+            ctx.policy = factory();
+        }
+        ctx.report       = {};
+        ctx.ms.gen_stats = {};
+    }
+
+    const int per_task = std::max(1, options.games_per_task);
+    const int tasks    = (options.games + per_task - 1) / per_task;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    pool.run(tasks, [&](int task, int worker) {
+        const int begin = task * per_task;
+        const int end   = std::min(options.games, begin + per_task);
+        for (int game = begin; game < end; game++) {
+            play(contexts[worker], options, game);
+        }
+    });
+
+    sim_report report;
+    for (const auto &ctx : contexts) {
+        report.merge(ctx.report);
+        report.generation.merge(ctx.ms.gen_stats);
+    }
+    report.seconds = elapsed_ns(start) / 1e9;
+
+    return report;
+}
+
+void rlms::simulator::play(worker_context &ctx, const sim_options &options, int game) {
+    auto &ms     = ctx.ms;
+    auto &report = ctx.report;
+
+    ms.cfg      = options.cfg;
+    ms.cfg.seed = derive_seed(options.cfg.seed, game);
+    ms.reset();
+    ctx.policy->begin(ms);
+
+    // Safety net for policies that stop making progress
+    const int max_clicks = ms.cfg.width * ms.cfg.height * 2;
+
+    const arena_stats scratch_start = ms.scratch.stats();
+    const auto        game_start    = std::chrono::steady_clock::now();
+
+    int clicks = 0;
+    while (ms.state == game_state::first_click || ms.state == game_state::playing) {
+        if (clicks == max_clicks) {
+            report.aborted++;
+            break;
+        }
+
+        const action a = ctx.policy->next(ms);
+
+        const auto click_start = std::chrono::steady_clock::now();
+        apply(ms, a);
+        report.click_latency.add(elapsed_ns(click_start));
+        clicks++;
+    }
+
+    report.game_latency.add(elapsed_ns(game_start));
+    report.scratch_allocations  += ms.scratch.stats().allocations - scratch_start.allocations;
+    report.upstream_allocations += ms.scratch.stats().upstream_allocations - scratch_start.upstream_allocations;
+    report.games++;
+    report.clicks += clicks;
+    report.bbbv   += ms.score.bbbv;
+
+    if (ms.state == game_state::won) report.wins++;
+    if (ms.state == game_state::lost) report.losses++;
+    if (ms.unsolvable) report.unsolvable++;
+}
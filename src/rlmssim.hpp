@@ -0,0 +1,128 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "rlms.hpp"
+#include "rlmspool.hpp"
+#include "rlmsrng.hpp"
+
+namespace rlms {
+
+/// Apply the player action on the board.
+void apply(minesweeper &ms, const action &a);
+
+/// Player policy, decides the next action from the board.
+struct player {
+    virtual ~player() = default;
+
+    /// Called before every game, after the board is reset.
+    virtual void begin(const minesweeper &) {}
+
+    /// Decide the next action.
+    virtual action next(const minesweeper &ms) = 0;
+};
+
+/// Built-in player that performs speed reveal and speed flag whenever the
+/// numbers force it, and guesses a random hidden cell otherwise.
+struct deduction_player : player {
+    void   begin(const minesweeper &ms) override;
+    action next(const minesweeper &ms) override;
+
+private:
+    philox4x32 gen;
+    int        cursor = 0; ///< Frontier position to resume scanning from.
+};
+
+/// Latency histogram with power-of-two nanosecond buckets.
+struct latency_histogram {
+    static constexpr int n_buckets = 48;
+
+    std::array<std::uint64_t, n_buckets> buckets = {}; ///< Bucket i counts samples in [2^i, 2^(i+1)) ns.
+    std::uint64_t                        count   = 0;  ///< Number of samples.
+    std::uint64_t                        max     = 0;  ///< Largest sample in ns.
+
+    /// Add a sample in nanoseconds.
+    void add(std::uint64_t ns);
+
+    /// Merge other histogram into this.
+    void merge(const latency_histogram &other);
+
+    /// Upper bound (in ns) of the bucket containing the given percentile,
+    /// where p in [0, 1].
+    std::uint64_t percentile(double p) const;
+};
+
+/// Simulation options.
+struct sim_options {
+    config cfg;                 ///< Board configuration. The seed is the base seed of all games.
+    int    games          = 1000; ///< Number of games to play.
+    int    games_per_task = 16;   ///< Number of games per pool task (the unit of stealing).
+};
+
+/// Simulation results.
+struct sim_report {
+    std::uint64_t games      = 0; ///< Games played.
+    std::uint64_t wins       = 0; ///< Games won.
+    std::uint64_t losses     = 0; ///< Games lost.
+    std::uint64_t aborted    = 0; ///< Games stopped by the click limit.
+    std::uint64_t unsolvable = 0; ///< Games generated as logically unsolvable.
+    std::uint64_t clicks     = 0; ///< Total clicks in all games.
+    double        seconds    = 0; ///< Wall clock time of the simulation.
+
+    std::uint64_t scratch_allocations  = 0; ///< Allocations served by the boards' scratch arenas.
+    std::uint64_t upstream_allocations = 0; ///< Allocations the scratch arenas made from their upstream.
+
+    std::uint64_t    bbbv = 0;   ///< Total 3BV of the boards played.
+    generation_stats generation; ///< Mine generation statistics, with the rejections of the difficulty filter.
+
+    latency_histogram game_latency;  ///< Time to play a game, including generation.
+    latency_histogram click_latency; ///< Time to apply a single click.
+
+    /// Merge other report into this. Wall clock time is not merged.
+    void merge(const sim_report &other);
+
+    double games_per_second() const;
+    double win_rate() const;
+    double clicks_per_game() const;
+    double bbbv_per_game() const;
+};
+
+/// Headless runner that plays many independent games in parallel.
+/// @note Each pool worker owns a board and a player, reused across all the
+///       games it runs, so boards of the same size are not reallocated.
+class simulator {
+public:
+    /// Creates a new player for a worker.
+    using player_factory = std::function<std::unique_ptr<player>()>;
+
+    simulator(thread_pool &pool, player_factory factory);
+
+    /// Play the games and report the results.
+    sim_report run(const sim_options &options);
+
+private:
+    /// Per-worker state.
+    struct worker_context {
+        minesweeper             ms;
+        std::unique_ptr<player> policy;
+        sim_report              report;
+    };
+
+    /// Play a single game on the worker context.
+    void play(worker_context &ctx, const sim_options &options, int game);
+
+    thread_pool                &pool;
+    player_factory              factory;
+    std::vector<worker_context> contexts;
+};
+
+}; // namespace rlms
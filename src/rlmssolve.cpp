@@ -0,0 +1,168 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <algorithm>
+
+#include "rlmssolve.hpp"
+
+rlms::tiled_solver::tiled_solver(thread_pool &pool, int tile_size)
+    : pool(pool), tile_size(std::max(tile_size, 4)) {}
+
+bool rlms::tiled_solver::solvable(minesweeper &ms, int x, int y) {
+    const int tiles_x = (ms.cfg.width + tile_size - 1) / tile_size;
+    const int tiles_y = (ms.cfg.height + tile_size - 1) / tile_size;
+    const int n_tiles = tiles_x * tiles_y;
+
+    if (n_tiles == 1 || pool.size() == 1) {
+        return ms.logically_solvable(x, y);
+    }
+
+    // The deduction needs every reveal to complete at once
+    const int budget  = ms.cascade_budget;
+    ms.cascade_budget = 0;
+
+    // Initial reveal
+    ms.reveal(x, y);
+
+    dirty.assign(n_tiles, true);
+    shared.assign(n_tiles, false);
+    queues.resize(pool.size());
+    for (auto &queue : queues) {
+        queue.reserve(tile_size * tile_size);
+    }
+
+    bool any_dirty = true;
+    while (any_dirty) {
+        any_dirty = false;
+
+        for (int color = 0; color < 4; color++) {
+            batch.clear();
+            for (int t = 0; t < n_tiles; t++) {
+                const int tx = t % tiles_x;
+                const int ty = t / tiles_x;
+                if (dirty[t] && (tx % 2) + (ty % 2) * 2 == color) {
+                    batch.push_back(t);
+                    dirty[t] = false;
+                }
+            }
+
+            if (batch.empty()) {
+                continue;
+            }
+
+            pool.run(batch.size(), [&](int task, int worker) {
+                const int t = batch[task];
+                shared[t]   = solve_tile(ms, t % tiles_x, t / tiles_x, queues[worker]);
+            });
+
+            // The tiles around a changed shared cell have to be solved again
+            for (int t : batch) {
+                if (!shared[t]) {
+                    continue;
+                }
+
+                const int tx = t % tiles_x;
+                const int ty = t / tiles_x;
+                for (int nx = std::max(tx - 1, 0); nx <= std::min(tx + 1, tiles_x - 1); nx++) {
+                    for (int ny = std::max(ty - 1, 0); ny <= std::min(ty + 1, tiles_y - 1); ny++) {
+                        if (nx != tx || ny != ty) {
+                            dirty[ny * tiles_x + nx] = true;
+                            any_dirty                = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // The board is logically solvable if the algorithm won the game
+    const bool solved = ms.check_won();
+
+    // Reset the board's cell state.
+    ms.reset_states();
+
+    ms.cascade_budget = budget;
+    return solved;
+}
+
+bool rlms::tiled_solver::solve_tile(minesweeper &ms, int tx, int ty, std::vector<std::pair<int, int>> &queue) {
+    const int x0 = tx * tile_size;
+    const int y0 = ty * tile_size;
+    const int x1 = std::min(x0 + tile_size, ms.cfg.width) - 1;
+    const int y1 = std::min(y0 + tile_size, ms.cfg.height) - 1;
+
+    const auto inside   = [&](int x, int y) { return x >= x0 && x <= x1 && y >= y0 && y <= y1; };
+    const auto interior = [&](int x, int y) { return x > x0 && x < x1 && y > y0 && y < y1; };
+
+    // Only the tile and its halo are written, the halo being the border of
+    // the tiles around. Changes to the tile's own border change their halo.
+    bool changed_shared = false;
+    const auto set      = [&](int x, int y, cell_state state) {
+        ms.set_cell_state(x, y, state);
+        changed_shared = changed_shared || !interior(x, y);
+    };
+
+    // Reveal the hidden cell, and flood through the 0 mines cells of the tile.
+    // The 0 mines cells of the halo are left to their own tiles.
+    const auto reveal = [&](int x, int y) {
+        set(x, y, cell_state::revealed);
+        if (ms.at(x, y).n_mines == 0 && inside(x, y)) {
+            queue.emplace_back(x, y);
+        }
+
+        while (!queue.empty()) {
+            auto [cx, cy] = queue.back();
+            queue.pop_back();
+
+            for (auto [nx, ny] : ms.neighbors(cx, cy)) {
+                if (ms.at(nx, ny).state != cell_state::hidden) {
+                    continue;
+                }
+
+                set(nx, ny, cell_state::revealed);
+                if (ms.at(nx, ny).n_mines == 0 && inside(nx, ny)) {
+                    queue.emplace_back(nx, ny);
+                }
+            }
+        }
+    };
+
+    // Same rules as minesweeper::logically_solvable
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        for (int x = x0; x <= x1; x++) {
+            for (int y = y0; y <= y1; y++) {
+                const cell &c = ms.at(x, y);
+                if (c.state != cell_state::revealed || c.n_hidden == 0) {
+                    continue;
+                }
+
+                // Rule 1: All mines are flagged, the hidden cells are safe
+                if (c.n_flagged == c.n_mines) {
+                    for (auto [nx, ny] : ms.neighbors(x, y)) {
+                        if (ms.at(nx, ny).state == cell_state::hidden) {
+                            reveal(nx, ny);
+                        }
+                    }
+                    progress = true;
+                    continue;
+                }
+
+                // Rule 2: All hidden cells are mines
+                if (c.n_flagged + c.n_hidden == c.n_mines) {
+                    for (auto [nx, ny] : ms.neighbors(x, y)) {
+                        if (ms.at(nx, ny).state == cell_state::hidden) {
+                            set(nx, ny, cell_state::flagged);
+                        }
+                    }
+                    progress = true;
+                }
+            }
+        }
+    }
+
+    return changed_shared;
+}
@@ -0,0 +1,50 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "rlms.hpp"
+#include "rlmspool.hpp"
+
+namespace rlms {
+
+/// Logical solver that splits the board into tiles and deduces on the tiles
+/// in parallel on a thread pool.
+/// @note The tiles are scheduled in 4 colors, so the tiles running at the
+///       same time are a whole tile apart, and each can read and write its
+///       one-cell halo directly. A tile is solved to its local fixpoint, and
+///       the tiles around it are solved again whenever it changes a cell they
+///       share, until no tile changes anything. The deductions are sound and
+///       only ever add to what is known, so this reaches the same fixpoint,
+///       and the same result, as minesweeper::logically_solvable.
+class tiled_solver {
+public:
+    /// Create the solver on the pool, with the given tile side length (at
+    /// least 4: a tile writes its halo cells, which also updates the neighbor
+    /// counts of the cells one further in, so the tile between two tiles
+    /// running at once needs room for both without overlap).
+    explicit tiled_solver(thread_pool &pool, int tile_size = 64);
+
+    /// Same as minesweeper::logically_solvable, on the pool.
+    /// @note Boards of a single tile are solved on the calling thread.
+    bool solvable(minesweeper &ms, int x, int y);
+
+private:
+    /// Solve the tile to its local fixpoint. Returns whether it changed a cell
+    /// shared with the tiles around it.
+    bool solve_tile(minesweeper &ms, int tx, int ty, std::vector<std::pair<int, int>> &queue);
+
+    thread_pool &pool;
+    int          tile_size;
+
+    std::vector<std::uint8_t>                     dirty;  ///< Whether the tile needs solving.
+    std::vector<std::uint8_t>                     shared; ///< Whether the last solve of the tile changed a shared cell.
+    std::vector<int>                              batch;  ///< Tiles being solved.
+    std::vector<std::vector<std::pair<int, int>>> queues; ///< Flood fill queue of every worker.
+};
+
+}; // namespace rlms
@@ -0,0 +1,181 @@
+/// @file
+/// @copyright (c) 2025 Anstro Pleuton
+/// This project is released under the Public Domain or licensed under the terms of MIT license.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "rlmssim.hpp"
+
+using namespace rlms;
+
+/// Number of heap allocations made through operator new, to check that the
+/// games do not allocate in steady-state.
+std::atomic<std::uint64_t> heapAllocations = 0;
+
+void *operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = (std::size_t)alignment;
+    if (void *p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+/// Print the usage of the headless simulator.
+void PrintUsage(const char *program) {
+    std::printf("Usage: %s [options]\n", program);
+    std::printf("  --width N      Board width (default 30).\n");
+    std::printf("  --height N     Board height (default 16).\n");
+    std::printf("  --mines N      Number of mines (default 99).\n");
+    std::printf("  --attempts N   Max generation attempts (default 100).\n");
+    std::printf("  --seed N       Base seed of all games (default random).\n");
+    std::printf("  --games N      Number of games to play (default 10000).\n");
+    std::printf("  --threads N    Number of worker threads (default all cores).\n");
+    std::printf("  --batch N      Games per task (default 16).\n");
+    std::printf("  --rng NAME     Mine generation engine: philox, splitmix, mt19937 or all\n");
+    std::printf("                 to compare the engines on the same games (default philox).\n");
+    std::printf("  --generator G  Mine generation algorithm: shuffle or constructive (default shuffle).\n");
+    std::printf("                 Shuffle rarely finds a solvable board above ~20%% mines, as on\n");
+    std::printf("                 the default expert board, use constructive there.\n");
+    std::printf("  --min-3bv N    Reject generated boards below the 3BV (default no limit).\n");
+    std::printf("  --max-3bv N    Reject generated boards above the 3BV (default no limit).\n");
+    std::printf("  --min-rounds N Reject generated boards solved in fewer deduction rounds.\n");
+    std::printf("  --max-rounds N Reject generated boards solved in more deduction rounds.\n");
+}
+
+/// Engine names, in the order of rng_engine.
+const char *engineNames[] = {"philox", "splitmix", "mt19937"};
+
+/// Print the histogram percentiles, in microseconds.
+void PrintLatency(const char *name, const latency_histogram &histogram) {
+    std::printf("%-14s p50 %10.1f us  p90 %10.1f us  p99 %10.1f us  max %10.1f us\n",
+                name,
+                histogram.percentile(0.50) / 1e3,
+                histogram.percentile(0.90) / 1e3,
+                histogram.percentile(0.99) / 1e3,
+                histogram.max / 1e3);
+}
+
+/// Print the generation attempts and why they were rejected.
+void PrintGeneration(const generation_stats &stats) {
+    const double attempts = stats.attempts ? (double)stats.attempts : 1.0;
+    std::printf("attempts/board %.2f\n", stats.boards ? (double)stats.attempts / stats.boards : 0.0);
+    std::printf("rejected       unsolvable %.1f%%, 3bv %.1f%%, rounds %.1f%% of attempts, %llu boards exhausted\n",
+                stats.unsolvable * 100.0 / attempts,
+                stats.bbbv_rejected * 100.0 / attempts,
+                stats.rounds_rejected * 100.0 / attempts,
+                (unsigned long long)stats.exhausted);
+}
+
+int main(int argc, char **argv) {
+    sim_options options;
+    options.cfg = {
+        .width  = 30,
+        .height = 16,
+        .mines  = 99,
+    };
+    options.cfg.randomize_seed();
+    options.games = 10000;
+
+    int  threads    = 0;
+    bool allEngines = false;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            PrintUsage(argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 1;
+        }
+
+        const char *value = argv[++i];
+
+        if (arg == "--width") options.cfg.width = std::atoi(value);
+        else if (arg == "--height") options.cfg.height = std::atoi(value);
+        else if (arg == "--mines") options.cfg.mines = std::atoi(value);
+        else if (arg == "--attempts") options.cfg.attempts = std::atoi(value);
+        else if (arg == "--seed") options.cfg.seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--games") options.games = std::atoi(value);
+        else if (arg == "--threads") threads = std::atoi(value);
+        else if (arg == "--batch") options.games_per_task = std::atoi(value);
+        else if (arg == "--min-3bv") options.cfg.filter.min_bbbv = std::atoi(value);
+        else if (arg == "--max-3bv") options.cfg.filter.max_bbbv = std::atoi(value);
+        else if (arg == "--min-rounds") options.cfg.filter.min_rounds = std::atoi(value);
+        else if (arg == "--max-rounds") options.cfg.filter.max_rounds = std::atoi(value);
+        else if (arg == "--rng") {
+            const std::string name = value;
+            allEngines             = name == "all";
+            if (name == "philox") options.cfg.engine = rng_engine::philox;
+            else if (name == "splitmix") options.cfg.engine = rng_engine::splitmix;
+            else if (name == "mt19937") options.cfg.engine = rng_engine::mt19937;
+            else if (!allEngines) {
+                std::fprintf(stderr, "Unknown engine %s\n", value);
+                return 1;
+            }
+        } else if (arg == "--generator") {
+            const std::string name = value;
+            if (name == "shuffle") options.cfg.generator = generator_algorithm::shuffle;
+            else if (name == "constructive") options.cfg.generator = generator_algorithm::constructive;
+            else {
+                std::fprintf(stderr, "Unknown generator %s\n", value);
+                return 1;
+            }
+        } else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!options.cfg.validate()) {
+        std::fprintf(stderr, "Invalid board configuration.\n");
+        return 1;
+    }
+
+    thread_pool pool(threads);
+    simulator   sim(pool, [] { return std::make_unique<deduction_player>(); });
+
+    std::printf("board          %dx%d, %d mines, seed %llu\n", options.cfg.width, options.cfg.height, options.cfg.mines, (unsigned long long)options.cfg.seed);
+    std::printf("threads        %d\n", pool.size());
+
+    for (int engine = 0; engine < 3; engine++) {
+        if (allEngines) options.cfg.engine = (rng_engine)engine;
+        else if (engine != (int)options.cfg.engine) continue;
+
+        const std::uint64_t heapStart = heapAllocations.load();
+        const sim_report    report    = sim.run(options);
+        const std::uint64_t heap      = heapAllocations.load() - heapStart;
+
+        std::printf("\nrng            %s\n", engineNames[(int)options.cfg.engine]);
+        std::printf("games          %llu\n", (unsigned long long)report.games);
+        std::printf("games/sec      %.1f\n", report.games_per_second());
+        std::printf("win rate       %.2f%%\n", report.win_rate() * 100.0);
+        std::printf("clicks/game    %.2f\n", report.clicks_per_game());
+        std::printf("unsolvable     %llu\n", (unsigned long long)report.unsolvable);
+        std::printf("aborted        %llu\n", (unsigned long long)report.aborted);
+        std::printf("3bv/game       %.2f\n", report.bbbv_per_game());
+        PrintGeneration(report.generation);
+        std::printf("heap allocs    %llu (%.3f/game)\n", (unsigned long long)heap, report.games ? (double)heap / report.games : 0.0);
+        std::printf("scratch allocs %llu (%llu from upstream)\n", (unsigned long long)report.scratch_allocations, (unsigned long long)report.upstream_allocations);
+        PrintLatency("game latency", report.game_latency);
+        PrintLatency("click latency", report.click_latency);
+    }
+}